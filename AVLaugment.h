@@ -0,0 +1,70 @@
+// AVLaugment.h
+#ifndef AVLAUGMENT_H
+#define AVLAUGMENT_H
+
+#include <algorithm>
+#include <limits>
+
+// Polityki wzbogacenia (augmentacji) węzłów AVLTree. Każdy węzeł przechowuje agregat
+// swojego poddrzewa, liczony w porządku inorder z monoidu opisanego przez politykę:
+//   typedef ... value_type;                      - typ agregatu (z konstruktorem domyślnym)
+//   static value_type identity();                - element neutralny
+//   static value_type lift(const T& value);      - agregat pojedynczego elementu
+//   static value_type combine(const value_type& a, const value_type& b) - łączne złożenie
+// Agregat przeliczany jest wszędzie tam, gdzie drzewo poprawia rozmiar poddrzewa
+// (rotacje, wyważanie, łączenie drzew), więc AVLTree::range_aggregate działa w O(log n).
+
+// Brak wzbogacenia - węzeł nie ma pola agregatu i drzewo nic za nie nie płaci
+struct NoAugment {};
+
+// Suma elementów
+template <typename T, typename V = T>
+struct SumAugment {
+    typedef V value_type;
+    static value_type identity() { return value_type(); }
+    static value_type lift(const T& value) { return static_cast<value_type>(value); }
+    static value_type combine(const value_type& a, const value_type& b) { return a + b; }
+};
+
+// Najmniejszy element
+template <typename T>
+struct MinAugment {
+    typedef T value_type;
+    static value_type identity() { return std::numeric_limits<T>::max(); }
+    static value_type lift(const T& value) { return value; }
+    static value_type combine(const value_type& a, const value_type& b) { return std::min(a, b); }
+};
+
+// Największy element
+template <typename T>
+struct MaxAugment {
+    typedef T value_type;
+    static value_type identity() { return std::numeric_limits<T>::lowest(); }
+    static value_type lift(const T& value) { return value; }
+    static value_type combine(const value_type& a, const value_type& b) { return std::max(a, b); }
+};
+
+// Drzewo przedziałów: elementy to pary (początek, koniec) uporządkowane po początku,
+// a agregat to największy koniec w poddrzewie. Pozwala to AVLTree::for_each_overlap
+// pomijać całe poddrzewa, których przedziały kończą się przed szukanym.
+template <typename K>
+struct IntervalMaxEndAugment {
+    typedef K value_type;
+    static value_type identity() { return std::numeric_limits<K>::lowest(); }
+
+    template <typename Interval>
+    static value_type lift(const Interval& interval) { return interval.second; }
+
+    static value_type combine(const value_type& a, const value_type& b) { return std::max(a, b); }
+};
+
+// Pole agregatu w węźle; dla NoAugment struktura jest pusta
+template <typename Augment>
+struct AVLAggregate {
+    typename Augment::value_type aggregate;
+};
+
+template <>
+struct AVLAggregate<NoAugment> {};
+
+#endif // AVLAUGMENT_H
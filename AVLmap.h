@@ -0,0 +1,289 @@
+// AVLmap.h
+#ifndef AVLMAP_H
+#define AVLMAP_H
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "AVLtree.h"
+
+// Porządek elementów AVLMap: pary klucz-wartość porównywane są wyłącznie po kluczu.
+// Komparator jest przezroczysty, więc drzewo może szukać węzła samym kluczem,
+// bez budowania pary z atrapą wartości.
+template <typename K, typename V, typename Compare>
+struct AVLMapCompare {
+    typedef void is_transparent;
+    typedef std::pair<const K, V> value_type;
+
+    Compare comp;
+
+    AVLMapCompare(const Compare& comp = Compare()) : comp(comp) {}
+
+    bool operator()(const value_type& a, const value_type& b) const { return comp(a.first, b.first); }
+
+    template <typename Key>
+    bool operator()(const value_type& a, const Key& key) const { return comp(a.first, key); }
+
+    template <typename Key>
+    bool operator()(const Key& key, const value_type& b) const { return comp(key, b.first); }
+};
+
+// Mapa uporządkowana oparta na AVLTree. Klucz i wartość leżą razem w węźle drzewa,
+// więc wyszukiwanie to jedno zejście od korzenia. Jeśli Compare jest przezroczysty
+// (np. std::less<>), find i count przyjmują klucze innego typu - np. std::string_view
+// dla mapy z kluczem std::string - bez tworzenia tymczasowego klucza.
+template <typename K, typename V, typename Compare = std::less<K>, typename Allocator = PoolAllocator>
+class AVLMap : private AVLTree<std::pair<const K, V>, AVLMapCompare<K, V, Compare>, Allocator> {
+    typedef AVLTree<std::pair<const K, V>, AVLMapCompare<K, V, Compare>, Allocator> Base;
+    typedef typename Base::Node Node;
+
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<const K, V> value_type;
+    typedef Compare key_compare;
+    typedef AVLIterator<Node, value_type> iterator;
+    typedef AVLIterator<Node, const value_type> const_iterator;
+
+    /**
+     * @brief Konstruktor AVLMap.
+     * Tworzy pustą mapę.
+     */
+    AVLMap() {}
+
+    /**
+     * @brief Konstruktor AVLMap z podanym porządkiem kluczy.
+     * @param comp Komparator kluczy.
+     * @param alloc Alokator węzłów.
+     */
+    explicit AVLMap(const Compare& comp, const Allocator& alloc = Allocator())
+        : Base(AVLMapCompare<K, V, Compare>(comp), alloc) {}
+
+    /**
+     * @brief Konstruktor AVLMap z podaną polityką przydziału węzłów.
+     * @param alloc Alokator węzłów.
+     */
+    explicit AVLMap(const Allocator& alloc) : Base(alloc) {}
+
+    using Base::size;
+    using Base::empty;
+    using Base::clear;
+    using Base::getHeight;
+
+    /**
+     * @brief Zamienia zawartość dwóch map w czasie O(1).
+     */
+    void swap(AVLMap& other) noexcept {
+        Base::swap(other);
+    }
+
+    friend void swap(AVLMap& a, AVLMap& b) noexcept {
+        a.swap(b);
+    }
+
+    /**
+     * @brief Sprawdza wyważenie drzewa i rosnący porządek kluczy.
+     */
+    bool isValid() const {
+        return Base::isValid();
+    }
+
+    /**
+     * @brief Zwraca komparator kluczy.
+     */
+    key_compare key_comp() const {
+        return this->comp.comp;
+    }
+
+    iterator begin() { return iterator(this->minValueNode(this->root), &this->root); }
+    const_iterator begin() const { return const_iterator(this->minValueNode(this->root), &this->root); }
+    iterator end() { return iterator(nullptr, &this->root); }
+    const_iterator end() const { return const_iterator(nullptr, &this->root); }
+
+    /**
+     * @brief Wyszukuje element o podanym kluczu.
+     * @param key Szukany klucz.
+     * @return Iterator na znaleziony element lub end(), jeśli go nie ma.
+     */
+    iterator find(const K& key) {
+        return iterator(this->search(this->root, key), &this->root);
+    }
+
+    const_iterator find(const K& key) const {
+        return const_iterator(this->search(this->root, key), &this->root);
+    }
+
+    /**
+     * @brief Wyszukuje element kluczem innego typu (wymaga przezroczystego Compare).
+     * @param key Klucz porównywalny z kluczami mapy.
+     * @return Iterator na znaleziony element lub end(), jeśli go nie ma.
+     */
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    iterator find(const Key& key) {
+        return iterator(this->search(this->root, key), &this->root);
+    }
+
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator find(const Key& key) const {
+        return const_iterator(this->search(this->root, key), &this->root);
+    }
+
+    /**
+     * @brief Liczy elementy o podanym kluczu.
+     * @return 1, jeśli klucz występuje w mapie; w przeciwnym razie 0.
+     */
+    std::size_t count(const K& key) const {
+        return this->search(this->root, key) ? 1 : 0;
+    }
+
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    std::size_t count(const Key& key) const {
+        return this->search(this->root, key) ? 1 : 0;
+    }
+
+    /**
+     * @brief Zwraca wartość przypisaną do klucza.
+     * @throws std::out_of_range Jeśli klucza nie ma w mapie.
+     */
+    V& at(const K& key) {
+        return const_cast<V&>(static_cast<const AVLMap&>(*this).at(key));
+    }
+
+    const V& at(const K& key) const {
+        Node* node = this->search(this->root, key);
+        if (!node) {
+            throw std::out_of_range("Brak klucza w mapie. Nie można wykonać at().");
+        }
+        return node->value.second;
+    }
+
+    /**
+     * @brief Zwraca wartość przypisaną do klucza, wstawiając domyślną, jeśli klucza nie było.
+     */
+    V& operator[](const K& key) {
+        return tryEmplace(key).first->second;
+    }
+
+    V& operator[](K&& key) {
+        return tryEmplace(std::move(key)).first->second;
+    }
+
+    /**
+     * @brief Wstawia element, jeśli jego klucza nie ma jeszcze w mapie.
+     * @param value Para klucz-wartość.
+     * @return Iterator na element o danym kluczu i informacja, czy wstawienie się odbyło.
+     */
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return tryEmplace(value.first, value.second);
+    }
+
+    /**
+     * @brief Tworzy wartość w miejscu z args, jeśli klucza nie ma jeszcze w mapie.
+     *
+     * Gdy klucz już istnieje, argumenty nie są ani kopiowane, ani przenoszone.
+     *
+     * @param key Klucz nowego elementu.
+     * @param args Argumenty konstruktora wartości.
+     * @return Iterator na element o danym kluczu i informacja, czy wstawienie się odbyło.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        return tryEmplace(key, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        return tryEmplace(std::move(key), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Wstawia element lub nadpisuje wartość istniejącego klucza.
+     * @param key Klucz elementu.
+     * @param obj Nowa wartość.
+     * @return Iterator na element i true, jeśli element został wstawiony (false - nadpisany).
+     */
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& obj) {
+        return insertOrAssign(key, std::forward<M>(obj));
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(K&& key, M&& obj) {
+        return insertOrAssign(std::move(key), std::forward<M>(obj));
+    }
+
+    /**
+     * @brief Usuwa element o podanym kluczu.
+     * @return Liczba usuniętych elementów (0 lub 1).
+     */
+    std::size_t erase(const K& key) {
+        Node* node = this->search(this->root, key);
+        if (!node) return 0;
+        this->eraseNode(node);
+        return 1;
+    }
+
+    /**
+     * @brief Usuwa element wskazywany przez iterator.
+     * @param pos Iterator na usuwany element (różny od end()).
+     * @return Iterator na element następujący po usuniętym.
+     */
+    iterator erase(const_iterator pos) {
+        Node* node = pos.getNode();
+        assert(node != nullptr);
+        iterator next(node, &this->root);
+        ++next;
+        this->eraseNode(node);
+        return next;
+    }
+
+    /**
+     * @brief Zwraca iterator na pierwszy element o kluczu nie mniejszym niż key.
+     */
+    iterator lower_bound(const K& key) {
+        return iterator(this->lowerBound(key), &this->root);
+    }
+
+    const_iterator lower_bound(const K& key) const {
+        return const_iterator(this->lowerBound(key), &this->root);
+    }
+
+    /**
+     * @brief Zwraca iterator na pierwszy element o kluczu większym niż key.
+     */
+    iterator upper_bound(const K& key) {
+        return iterator(this->upperBound(key), &this->root);
+    }
+
+    const_iterator upper_bound(const K& key) const {
+        return const_iterator(this->upperBound(key), &this->root);
+    }
+
+private:
+    /**
+     * @brief Wspólna implementacja try_emplace - węzeł powstaje dopiero, gdy klucza nie ma w drzewie.
+     */
+    template <typename KeyArg, typename... Args>
+    std::pair<iterator, bool> tryEmplace(KeyArg&& key, Args&&... args) {
+        Node* parent;
+        bool toLeft;
+        Node* node = this->findInsertPos(key, parent, toLeft);
+        if (node) return std::make_pair(iterator(node, &this->root), false);
+        node = this->createNode(std::piecewise_construct,
+                                std::forward_as_tuple(std::forward<KeyArg>(key)),
+                                std::forward_as_tuple(std::forward<Args>(args)...));
+        this->insertNode(node, parent, toLeft);
+        return std::make_pair(iterator(node, &this->root), true);
+    }
+
+    template <typename KeyArg, typename M>
+    std::pair<iterator, bool> insertOrAssign(KeyArg&& key, M&& obj) {
+        std::pair<iterator, bool> result = tryEmplace(std::forward<KeyArg>(key), std::forward<M>(obj));
+        if (!result.second) result.first->second = std::forward<M>(obj);
+        return result;
+    }
+};
+
+#endif // AVLMAP_H
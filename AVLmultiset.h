@@ -0,0 +1,227 @@
+// AVLmultiset.h
+#ifndef AVLMULTISET_H
+#define AVLMULTISET_H
+
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include "AVLmap.h"
+
+// Wielozbiór uporządkowany oparty na AVLTree. Powtórzenia klucza nie tworzą nowych
+// węzłów - każdy węzeł przechowuje parę (klucz, krotność), więc przy wielu duplikatach
+// pamięć rośnie z liczbą różnych kluczy, a nie z liczbą wystąpień. Iteratory przechodzą
+// po różnych kluczach w porządku rosnącym i zwracają pary (klucz, krotność).
+template <typename T, typename Compare = std::less<T>, typename Allocator = PoolAllocator>
+class AVLMultiset : private AVLTree<std::pair<const T, std::size_t>, AVLMapCompare<T, std::size_t, Compare>, Allocator> {
+    typedef AVLTree<std::pair<const T, std::size_t>, AVLMapCompare<T, std::size_t, Compare>, Allocator> Base;
+    typedef typename Base::Node Node;
+
+public:
+    typedef T key_type;
+    typedef std::pair<const T, std::size_t> value_type;
+    typedef Compare key_compare;
+    typedef AVLIterator<Node, const value_type> const_iterator;
+    typedef const_iterator iterator;
+
+    /**
+     * @brief Konstruktor AVLMultiset.
+     * Tworzy pusty wielozbiór.
+     */
+    AVLMultiset() : total(0) {}
+
+    /**
+     * @brief Konstruktor AVLMultiset z podanym porządkiem kluczy.
+     * @param comp Komparator kluczy.
+     * @param alloc Alokator węzłów.
+     */
+    explicit AVLMultiset(const Compare& comp, const Allocator& alloc = Allocator())
+        : Base(AVLMapCompare<T, std::size_t, Compare>(comp), alloc), total(0) {}
+
+    /**
+     * @brief Konstruktor AVLMultiset z podaną polityką przydziału węzłów.
+     * @param alloc Alokator węzłów.
+     */
+    explicit AVLMultiset(const Allocator& alloc) : Base(alloc), total(0) {}
+
+    AVLMultiset(const AVLMultiset&) = default;
+    AVLMultiset& operator=(const AVLMultiset&) = default;
+
+    /**
+     * @brief Konstruktor przenoszący - przejmuje węzły i licznik wystąpień; other zostaje pusty.
+     */
+    AVLMultiset(AVLMultiset&& other) noexcept : Base(std::move(other)), total(other.total) {
+        other.total = 0;
+    }
+
+    /**
+     * @brief Przenoszący operator przypisania - zwalnia bieżące elementy i przejmuje elementy other.
+     */
+    AVLMultiset& operator=(AVLMultiset&& other) noexcept {
+        if (this != &other) {
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+
+    using Base::empty;
+    using Base::getHeight;
+
+    /**
+     * @brief Zwraca łączną liczbę wystąpień wszystkich kluczy.
+     */
+    std::size_t size() const {
+        return total;
+    }
+
+    /**
+     * @brief Zwraca liczbę różnych kluczy (czyli węzłów drzewa).
+     */
+    std::size_t distinct() const {
+        return Base::size();
+    }
+
+    /**
+     * @brief Usuwa wszystkie elementy.
+     */
+    void clear() {
+        Base::clear();
+        total = 0;
+    }
+
+    /**
+     * @brief Zamienia zawartość dwóch wielozbiorów w czasie O(1).
+     */
+    void swap(AVLMultiset& other) noexcept {
+        Base::swap(other);
+        std::swap(total, other.total);
+    }
+
+    friend void swap(AVLMultiset& a, AVLMultiset& b) noexcept {
+        a.swap(b);
+    }
+
+    /**
+     * @brief Sprawdza wyważenie drzewa, porządek kluczy i zgodność krotności z size().
+     */
+    bool isValid() const {
+        if (!Base::isValid()) return false;
+        std::size_t sum = 0;
+        for (const_iterator it = begin(); it != end(); ++it) {
+            if (it->second == 0) return false;
+            sum += it->second;
+        }
+        return sum == total;
+    }
+
+    /**
+     * @brief Zwraca komparator kluczy.
+     */
+    key_compare key_comp() const {
+        return this->comp.comp;
+    }
+
+    const_iterator begin() const { return const_iterator(this->minValueNode(this->root), &this->root); }
+    const_iterator end() const { return const_iterator(nullptr, &this->root); }
+
+    /**
+     * @brief Dodaje jedno wystąpienie klucza.
+     *
+     * Jeśli klucz już występuje, zwiększana jest tylko jego krotność - bez nowego
+     * węzła i bez wyważania drzewa.
+     *
+     * @param key Dodawany klucz.
+     * @return Krotność klucza po wstawieniu.
+     */
+    std::size_t insert(const T& key) {
+        return insertKey(key);
+    }
+
+    std::size_t insert(T&& key) {
+        return insertKey(std::move(key));
+    }
+
+    /**
+     * @brief Zwraca liczbę wystąpień klucza.
+     */
+    std::size_t count(const T& key) const {
+        Node* node = this->search(this->root, key);
+        return node ? node->value.second : 0;
+    }
+
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    std::size_t count(const Key& key) const {
+        Node* node = this->search(this->root, key);
+        return node ? node->value.second : 0;
+    }
+
+    /**
+     * @brief Wyszukuje klucz.
+     * @return Iterator na parę (klucz, krotność) lub end(), jeśli klucza nie ma.
+     */
+    const_iterator find(const T& key) const {
+        return const_iterator(this->search(this->root, key), &this->root);
+    }
+
+    /**
+     * @brief Usuwa jedno wystąpienie klucza; węzeł znika razem z ostatnim wystąpieniem.
+     * @return true, jeśli klucz występował; w przeciwnym razie false.
+     */
+    bool remove_one(const T& key) {
+        Node* node = this->search(this->root, key);
+        if (!node) return false;
+        --total;
+        if (--node->value.second == 0) this->eraseNode(node);
+        return true;
+    }
+
+    /**
+     * @brief Usuwa wszystkie wystąpienia klucza.
+     * @return Liczba usuniętych wystąpień (0, jeśli klucza nie było).
+     */
+    std::size_t remove_all(const T& key) {
+        Node* node = this->search(this->root, key);
+        if (!node) return 0;
+        std::size_t removed = node->value.second;
+        total -= removed;
+        this->eraseNode(node);
+        return removed;
+    }
+
+    /**
+     * @brief Zwraca iterator na pierwszy klucz nie mniejszy niż key.
+     */
+    const_iterator lower_bound(const T& key) const {
+        return const_iterator(this->lowerBound(key), &this->root);
+    }
+
+    /**
+     * @brief Zwraca iterator na pierwszy klucz większy niż key.
+     */
+    const_iterator upper_bound(const T& key) const {
+        return const_iterator(this->upperBound(key), &this->root);
+    }
+
+private:
+    template <typename KeyArg>
+    std::size_t insertKey(KeyArg&& key) {
+        Node* parent;
+        bool toLeft;
+        Node* node = this->findInsertPos(key, parent, toLeft);
+        if (node) {
+            ++total;
+            return ++node->value.second;
+        }
+        node = this->createNode(std::piecewise_construct,
+                                std::forward_as_tuple(std::forward<KeyArg>(key)),
+                                std::forward_as_tuple(std::size_t(1)));
+        this->insertNode(node, parent, toLeft);
+        ++total;
+        return 1;
+    }
+
+    std::size_t total; // łączna liczba wystąpień
+};
+
+#endif // AVLMULTISET_H
@@ -0,0 +1,103 @@
+// AVLobserver.h
+#ifndef AVLOBSERVER_H
+#define AVLOBSERVER_H
+
+#include <iostream>
+#include <type_traits>
+#include <utility>
+
+// Sprawdza, czy wartość typu T można wypisać operatorem <<
+template <typename T, typename = void>
+struct IsPrintable : std::false_type {};
+
+template <typename T>
+struct IsPrintable<T, std::void_t<decltype(std::declval<std::ostream&>() << std::declval<const T&>())> >
+    : std::true_type {};
+
+/**
+ * @brief Wypisuje wartość węzła w komunikatach diagnostycznych.
+ * Wartości bez operatora << zastępowane są znakiem '?'.
+ */
+template <typename T>
+void printValue(std::ostream& out, const T& value) {
+    if constexpr (IsPrintable<T>::value) {
+        out << value;
+    } else {
+        out << '?';
+    }
+}
+
+/**
+ * @brief Wypisuje element AVLMap - wystarczy sam klucz, bo to on wyznacza kształt drzewa.
+ */
+template <typename K, typename V>
+void printValue(std::ostream& out, const std::pair<K, V>& value) {
+    printValue(out, value.first);
+}
+
+// Kierunek rotacji zgłaszanej obserwatorowi
+enum class AVLRotation { Left, Right };
+
+// Obserwator to parametr szablonu AVLTree, który dostaje wywołania zwrotne przy zmianach
+// struktury drzewa:
+//   on_rotate(pivot, direction) - przed rotacją węzła o wartości pivot,
+//   on_insert(tree, value)      - po wstawieniu pojedynczego elementu i wyważeniu drzewa,
+//   on_erase(tree, value)       - po usunięciu elementu i wyważeniu, zanim węzeł zostanie zniszczony.
+// Rotacje wykonywane są także przez operacje łączące i równoległe, dlatego on_rotate nie dostaje
+// drzewa (jego korzeń może być wtedy chwilowo nieaktualny). W operacjach parallel_* on_rotate
+// wołane jest z wątków puli, ale drzewo szereguje te wywołania muteksem, więc obserwator
+// nie musi być bezpieczny wielowątkowo.
+
+// Obserwator domyślny - puste metody znikają po wkompilowaniu, więc drzewo nic za nie nie płaci
+struct NullObserver {
+    template <typename V>
+    void on_rotate(const V&, AVLRotation) {}
+
+    template <typename Tree, typename V>
+    void on_insert(const Tree&, const V&) {}
+
+    template <typename Tree, typename V>
+    void on_erase(const Tree&, const V&) {}
+};
+
+// Obserwator wypisujący przebieg operacji i drzewo po każdej zmianie (wizualizacja w programie testowym)
+class TracingObserver {
+public:
+    /**
+     * @brief Konstruktor TracingObserver.
+     * @param out Strumień wyjściowy; nullptr wyłącza wypisywanie.
+     */
+    explicit TracingObserver(std::ostream* out = &std::cout) : out(out) {}
+
+    template <typename V>
+    void on_rotate(const V& pivot, AVLRotation direction) {
+        if (!out) return;
+        *out << (direction == AVLRotation::Left ? "Rotacja w lewo węzła: " : "Rotacja w prawo węzła: ");
+        printValue(*out, pivot);
+        *out << std::endl;
+    }
+
+    template <typename Tree, typename V>
+    void on_insert(const Tree& tree, const V& value) {
+        report("Wstawiono węzeł: ", tree, value);
+    }
+
+    template <typename Tree, typename V>
+    void on_erase(const Tree& tree, const V& value) {
+        report("Usunięto węzeł: ", tree, value);
+    }
+
+private:
+    template <typename Tree, typename V>
+    void report(const char* message, const Tree& tree, const V& value) {
+        if (!out) return;
+        *out << message;
+        printValue(*out, value);
+        *out << std::endl;
+        tree.display(*out);
+    }
+
+    std::ostream* out;
+};
+
+#endif // AVLOBSERVER_H
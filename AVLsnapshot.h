@@ -0,0 +1,188 @@
+// AVLsnapshot.h
+#ifndef AVLSNAPSHOT_H
+#define AVLSNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Binarny zapis drzewa AVL (AVLTree::save / AVLTree::load / MappedAVL).
+// Plik składa się z nagłówka, tablicy wartości w kolejności preorder i tablicy
+// rozmiarów lewych poddrzew (uint32) w tej samej kolejności. Lewe dziecko węzła i
+// leży pod indeksem i + 1, a prawe pod i + 1 + leftSizes[i], więc kształt drzewa
+// jest zachowany i można go przeszukiwać bez wczytywania. Liczby zapisywane są
+// w porządku bajtów maszyny, na której powstał plik.
+struct AVLSnapshotHeader {
+    char magic[8];                // "AVLSNAP"
+    std::uint32_t version;        // wersja formatu
+    std::uint32_t valueSize;      // sizeof(T)
+    std::uint64_t typeTag;        // skrót nazwy typu T
+    std::uint64_t count;          // liczba elementów
+    std::uint64_t valuesOffset;   // początek tablicy wartości
+    std::uint64_t leftSizesOffset; // początek tablicy rozmiarów lewych poddrzew
+};
+
+const std::uint32_t AVLSnapshotVersion = 1;
+
+// Wysokość drzewa AVL o 2^32 węzłach nie przekracza 1.44 * 32; głębsze drzewo oznacza uszkodzony plik
+const int AVLSnapshotMaxDepth = 64;
+
+/**
+ * @brief Wyznacza znacznik typu zapisywany w nagłówku (skrót FNV-1a nazwy typu).
+ */
+template <typename T>
+std::uint64_t snapshotTypeTag() {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const char* c = typeid(T).name(); *c; ++c) {
+        hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Tworzy nagłówek pliku dla count elementów typu T.
+ */
+template <typename T>
+AVLSnapshotHeader makeSnapshotHeader(std::uint64_t count) {
+    AVLSnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "AVLSNAP", 8);
+    header.version = AVLSnapshotVersion;
+    header.valueSize = sizeof(T);
+    header.typeTag = snapshotTypeTag<T>();
+    header.count = count;
+    // Wartości zaczynają się na granicy 64 bajtów, a rozmiary - na granicy 8 bajtów
+    header.valuesOffset = 64;
+    header.leftSizesOffset = (header.valuesOffset + count * sizeof(T) + 7) / 8 * 8;
+    return header;
+}
+
+/**
+ * @brief Sprawdza, czy nagłówek opisuje plik z elementami typu T mieszczący się w fileSize bajtach.
+ */
+template <typename T>
+bool checkSnapshotHeader(const AVLSnapshotHeader& header, std::uint64_t fileSize) {
+    AVLSnapshotHeader expected = makeSnapshotHeader<T>(header.count);
+    return std::memcmp(header.magic, expected.magic, 8) == 0 && header.version == AVLSnapshotVersion &&
+           header.valueSize == expected.valueSize && header.typeTag == expected.typeTag &&
+           header.count <= 0xFFFFFFFFull && header.valuesOffset == expected.valuesOffset &&
+           header.leftSizesOffset == expected.leftSizesOffset &&
+           header.leftSizesOffset + header.count * sizeof(std::uint32_t) <= fileSize;
+}
+
+// Widok tylko do odczytu na plik zapisany przez AVLTree::save. Plik jest mapowany
+// do pamięci (mmap) i przeszukiwany w miejscu, bez wczytywania i budowania węzłów,
+// więc czas otwarcia nie zależy od liczby elementów - strony pliku wczytuje system
+// przy pierwszym dostępie. Wszystkie metody są const i mogą działać z wielu wątków.
+template <typename T, typename Compare = std::less<T> >
+class MappedAVL {
+    static_assert(std::is_trivially_copyable<T>::value, "MappedAVL wymaga typu trywialnie kopiowalnego");
+
+public:
+    /**
+     * @brief Mapuje plik zapisany przez AVLTree::save.
+     * @param path Ścieżka do pliku.
+     * @param comp Komparator, którym uporządkowano zapisane drzewo.
+     * @throws std::runtime_error Jeśli plik nie istnieje albo nie zawiera drzewa elementów typu T.
+     */
+    explicit MappedAVL(const std::string& path, const Compare& comp = Compare())
+        : base(nullptr), length(0), values(nullptr), leftSizes(nullptr), count(0), comp(comp) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Nie można otworzyć pliku " + path + ". Nie można wykonać MappedAVL().");
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<std::uint64_t>(info.st_size) < sizeof(AVLSnapshotHeader)) {
+            ::close(fd);
+            throw std::runtime_error("Niepoprawny plik " + path + ". Nie można wykonać MappedAVL().");
+        }
+        length = static_cast<std::size_t>(info.st_size);
+        base = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            base = nullptr;
+            throw std::runtime_error("Nie można zmapować pliku " + path + ". Nie można wykonać MappedAVL().");
+        }
+        AVLSnapshotHeader header;
+        std::memcpy(&header, base, sizeof(header));
+        if (!checkSnapshotHeader<T>(header, length)) {
+            ::munmap(base, length);
+            throw std::runtime_error("Niepoprawny plik " + path + ". Nie można wykonać MappedAVL().");
+        }
+        const char* bytes = static_cast<const char*>(base);
+        count = static_cast<std::size_t>(header.count);
+        values = reinterpret_cast<const T*>(bytes + header.valuesOffset);
+        leftSizes = reinterpret_cast<const std::uint32_t*>(bytes + header.leftSizesOffset);
+    }
+
+    ~MappedAVL() {
+        if (base) ::munmap(base, length);
+    }
+
+    MappedAVL(const MappedAVL&) = delete;
+    MappedAVL& operator=(const MappedAVL&) = delete;
+
+    MappedAVL(MappedAVL&& other) noexcept
+        : base(other.base), length(other.length), values(other.values), leftSizes(other.leftSizes),
+          count(other.count), comp(other.comp) {
+        other.base = nullptr;
+        other.count = 0;
+    }
+
+    /**
+     * @brief Wyszukuje wartość w zmapowanym pliku.
+     * @return true, jeśli wartość istnieje; w przeciwnym razie false.
+     */
+    bool search(const T& value) const {
+        return find(value) != nullptr;
+    }
+
+    /**
+     * @brief Zwraca wskaźnik na element równy value, leżący w zmapowanej pamięci.
+     *
+     * Zejście korzysta z rozmiarów lewych poddrzew; rozmiar bieżącego poddrzewa
+     * maleje w każdym kroku, więc nawet uszkodzony plik nie wyprowadzi poza tablice.
+     *
+     * @return Wskaźnik na element lub nullptr, jeśli go nie ma.
+     */
+    const T* find(const T& value) const {
+        std::size_t index = 0;
+        std::size_t remaining = count;
+        while (remaining) {
+            std::size_t leftCount = leftSizes[index];
+            if (leftCount >= remaining) return nullptr;
+            if (comp(value, values[index])) {
+                remaining = leftCount;
+                index += 1;
+            } else if (comp(values[index], value)) {
+                remaining -= leftCount + 1;
+                index += leftCount + 1;
+            } else {
+                return values + index;
+            }
+        }
+        return nullptr;
+    }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    void* base;
+    std::size_t length;
+    const T* values;
+    const std::uint32_t* leftSizes;
+    std::size_t count;
+    Compare comp;
+};
+
+#endif // AVLSNAPSHOT_H
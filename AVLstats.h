@@ -0,0 +1,108 @@
+// AVLstats.h
+#ifndef AVLSTATS_H
+#define AVLSTATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Liczniki operacji drzewa włączane makrem AVLTREE_STATS (np. -DAVLTREE_STATS).
+// Bez makra AVL_STAT nic nie robi, a drzewo nie ma pola z licznikami,
+// więc ani czas, ani rozmiar obiektu się nie zmieniają.
+#ifdef AVLTREE_STATS
+#define AVL_STAT_ADD(counter, n) (this->counters.counter.fetch_add((n), std::memory_order_relaxed))
+#else
+#define AVL_STAT_ADD(counter, n) ((void)(n))
+#endif
+#define AVL_STAT(counter) AVL_STAT_ADD(counter, 1)
+
+// Migawka statystyk drzewa gotowa do eksportu
+struct AVLStats {
+    bool enabled;                   // czy drzewo skompilowano z AVLTREE_STATS
+    std::uint64_t singleRotations;  // wyważenia jedną rotacją
+    std::uint64_t doubleRotations;  // wyważenia dwiema rotacjami
+    std::uint64_t searches;         // zejścia od korzenia (wyszukiwanie, wstawianie, usuwanie, granice)
+    std::uint64_t comparisons;      // porównania klucza z węzłem - po jednym na odwiedzony węzeł
+    std::uint64_t allocations;      // utworzone węzły
+    std::uint64_t frees;            // zwolnione węzły
+    std::uint64_t updates;          // wstawienia i usunięcia pojedynczych węzłów
+    std::uint64_t rebalanceSteps;   // węzły wyważone podczas powrotu w górę po zmianach
+    std::vector<std::size_t> depthHistogram; // depthHistogram[d] - liczba węzłów na głębokości d
+
+    double comparisonsPerSearch() const {
+        return searches ? static_cast<double>(comparisons) / searches : 0.0;
+    }
+
+    double rebalanceStepsPerUpdate() const {
+        return updates ? static_cast<double>(rebalanceSteps) / updates : 0.0;
+    }
+
+    /**
+     * @brief Zapisuje migawkę jako jeden obiekt JSON.
+     */
+    std::string to_json() const {
+        std::ostringstream out;
+        out << "{\"enabled\": " << (enabled ? "true" : "false")
+            << ", \"single_rotations\": " << singleRotations
+            << ", \"double_rotations\": " << doubleRotations
+            << ", \"searches\": " << searches
+            << ", \"comparisons\": " << comparisons
+            << ", \"comparisons_per_search\": " << comparisonsPerSearch()
+            << ", \"allocations\": " << allocations
+            << ", \"frees\": " << frees
+            << ", \"updates\": " << updates
+            << ", \"rebalance_steps\": " << rebalanceSteps
+            << ", \"rebalance_steps_per_update\": " << rebalanceStepsPerUpdate()
+            << ", \"depth_histogram\": [";
+        for (std::size_t i = 0; i < depthHistogram.size(); ++i) {
+            out << (i ? ", " : "") << depthHistogram[i];
+        }
+        out << "]}";
+        return out.str();
+    }
+};
+
+// Liczniki przechowywane w drzewie. Operacje równoległe tworzą i zwalniają węzły
+// z wielu wątków, dlatego liczniki są atomowe (z porządkiem relaxed). Kopia drzewa
+// zaczyna liczenie od zera, a przeniesione drzewo zachowuje swoje liczniki.
+struct AVLCounters {
+    std::atomic<std::uint64_t> singleRotations, doubleRotations, searches, comparisons,
+                               allocations, frees, updates, rebalanceSteps;
+
+    AVLCounters() { reset(); }
+    AVLCounters(const AVLCounters&) { reset(); }
+    AVLCounters& operator=(const AVLCounters&) { return *this; }
+
+    void reset() {
+        singleRotations = doubleRotations = searches = comparisons = 0;
+        allocations = frees = updates = rebalanceSteps = 0;
+    }
+
+    // Przeniesione drzewo zabiera liczniki ze sobą, a źródło liczy od zera
+    void takeFrom(AVLCounters& other) {
+        singleRotations = other.singleRotations.exchange(0, std::memory_order_relaxed);
+        doubleRotations = other.doubleRotations.exchange(0, std::memory_order_relaxed);
+        searches = other.searches.exchange(0, std::memory_order_relaxed);
+        comparisons = other.comparisons.exchange(0, std::memory_order_relaxed);
+        allocations = other.allocations.exchange(0, std::memory_order_relaxed);
+        frees = other.frees.exchange(0, std::memory_order_relaxed);
+        updates = other.updates.exchange(0, std::memory_order_relaxed);
+        rebalanceSteps = other.rebalanceSteps.exchange(0, std::memory_order_relaxed);
+    }
+
+    void copyTo(AVLStats& stats) const {
+        stats.singleRotations = singleRotations.load(std::memory_order_relaxed);
+        stats.doubleRotations = doubleRotations.load(std::memory_order_relaxed);
+        stats.searches = searches.load(std::memory_order_relaxed);
+        stats.comparisons = comparisons.load(std::memory_order_relaxed);
+        stats.allocations = allocations.load(std::memory_order_relaxed);
+        stats.frees = frees.load(std::memory_order_relaxed);
+        stats.updates = updates.load(std::memory_order_relaxed);
+        stats.rebalanceSteps = rebalanceSteps.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // AVLSTATS_H
@@ -2,55 +2,220 @@
 #ifndef AVLTREE_H
 #define AVLTREE_H
 
+#include <functional>
+#include <algorithm>
 #include <iostream>
-#include <queue>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
 #include <cassert>
-
-// Struktura AVLNode przechowująca pojedynczą wartość i wskaźniki na dzieci oraz rodzica
-template <typename T>
-struct AVLNode {
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "NodePool.h"
+#include "ForkJoinPool.h"
+#include "FrozenAVLtree.h"
+#include "AVLstats.h"
+#include "AVLobserver.h"
+#include "AVLsnapshot.h"
+#include "AVLaugment.h"
+
+// Struktura AVLNode przechowująca pojedynczą wartość, wysokość i rozmiar poddrzewa
+// oraz wskaźniki na dzieci i rodzica; z polityką Augment także agregat poddrzewa (AVLaugment.h)
+template <typename T, typename Augment = NoAugment>
+struct AVLNode : AVLAggregate<Augment> {
     T value;
     int height;
+    std::size_t size;
     AVLNode *left, *right, *up;
 
     /**
      * @brief Domyślny konstruktor AVLNode.
-     * Inicjalizuje wartość węzła jako domyślną dla typu T, a wysokość jako 1.
+     * Inicjalizuje wartość węzła jako domyślną dla typu T, a wysokość i rozmiar jako 1.
      */
-    AVLNode() : value(T()), height(1), left(nullptr), right(nullptr), up(nullptr) {}
+    AVLNode() : value(T()), height(1), size(1), left(nullptr), right(nullptr), up(nullptr) {}
 
     /**
      * @brief Konstruktor inicjalizujący węzeł z podaną wartością.
      * @param item Wartość do przypisania nowemu węzłowi.
      */
-    explicit AVLNode(const T& item) : value(item), height(1), left(nullptr), right(nullptr), up(nullptr) {}
+    explicit AVLNode(const T& item) : value(item), height(1), size(1), left(nullptr), right(nullptr), up(nullptr) {}
+
+    /**
+     * @brief Konstruktor tworzący wartość węzła w miejscu z podanych argumentów.
+     * @param args Argumenty przekazywane do konstruktora typu T.
+     */
+    template <typename... Args>
+    explicit AVLNode(std::in_place_t, Args&&... args)
+        : value(std::forward<Args>(args)...), height(1), size(1), left(nullptr), right(nullptr), up(nullptr) {}
+};
+
+// Iterator dwukierunkowy przechodzący po węzłach drzewa w kolejności inorder.
+// Przejście do następnika korzysta ze wskaźników up, więc pełny przebieg kosztuje O(n).
+template <typename Node, typename Value>
+class AVLIterator {
+public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef typename std::remove_const<Value>::type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Value* pointer;
+    typedef Value& reference;
+
+    AVLIterator() : node(nullptr), root(nullptr) {}
+
+    /**
+     * @brief Tworzy iterator wskazujący na węzeł.
+     * @param node Wskazywany węzeł; nullptr oznacza pozycję end().
+     * @param root Adres wskaźnika na korzeń drzewa, potrzebny do cofnięcia się z end().
+     */
+    AVLIterator(Node* node, Node* const* root) : node(node), root(root) {}
 
     /**
-     * @brief Destruktor AVLNode.
-     * Usuwa rekurencyjnie lewe i prawe poddrzewo.
+     * @brief Konwersja iteratora modyfikującego na iterator stały.
      */
-    ~AVLNode() {
-        delete left;
-        delete right;
+    template <typename Other,
+              typename = typename std::enable_if<std::is_same<const Other, Value>::value &&
+                                                 !std::is_const<Other>::value>::type>
+    AVLIterator(const AVLIterator<Node, Other>& other) : node(other.node), root(other.root) {}
+
+    reference operator*() const { return node->value; }
+    pointer operator->() const { return &node->value; }
+
+    AVLIterator& operator++() {
+        if (node->right) {
+            node = node->right;
+            while (node->left) node = node->left;
+        } else {
+            while (node->up && node == node->up->right) node = node->up;
+            node = node->up;
+        }
+        return *this;
+    }
+
+    AVLIterator& operator--() {
+        if (!node) {
+            node = *root;
+            while (node && node->right) node = node->right;
+        } else if (node->left) {
+            node = node->left;
+            while (node->right) node = node->right;
+        } else {
+            while (node->up && node == node->up->left) node = node->up;
+            node = node->up;
+        }
+        return *this;
+    }
+
+    AVLIterator operator++(int) {
+        AVLIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    AVLIterator operator--(int) {
+        AVLIterator old = *this;
+        --*this;
+        return old;
     }
+
+    bool operator==(const AVLIterator& other) const { return node == other.node; }
+    bool operator!=(const AVLIterator& other) const { return node != other.node; }
+
+    /**
+     * @brief Zwraca węzeł, na który wskazuje iterator.
+     * @return Wskaźnik do węzła lub nullptr dla end().
+     */
+    Node* getNode() const { return node; }
+
+private:
+    template <typename, typename> friend class AVLIterator;
+
+    Node* node;
+    Node* const* root;
 };
 
 // Template class dla AVLTree
-template <typename T>
+// Compare to porządek elementów (domyślnie std::less<T>); komparator przezroczysty,
+// np. std::less<>, pozwala wyszukiwać kluczem innego typu bez tworzenia obiektu T.
+// Allocator to polityka przydziału węzłów (PoolAllocator, ArenaAllocator lub HeapAllocator z NodePool.h)
+// Observer dostaje wywołania zwrotne o rotacjach, wstawieniach i usunięciach (AVLobserver.h);
+// domyślny NullObserver nic nie robi i nie kosztuje.
+// Augment to polityka agregatu poddrzewa dla range_aggregate (AVLaugment.h); domyślnie brak.
+template <typename T, typename Compare = std::less<T>, typename Allocator = PoolAllocator,
+          typename Observer = NullObserver, typename Augment = NoAugment>
 class AVLTree {
 public:
+    typedef AVLNode<T, Augment> Node;
+    typedef AVLIterator<Node, const T> iterator;
+    typedef iterator const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef reverse_iterator const_reverse_iterator;
+
     /**
      * @brief Konstruktor AVLTree.
      * Tworzy pustą strukturę drzewa AVL.
      */
-    AVLTree() : root(nullptr) {}
+    AVLTree() : root(nullptr), allocLock(nullptr) {}
+
+    /**
+     * @brief Konstruktor AVLTree z podaną polityką przydziału węzłów.
+     * @param alloc Alokator węzłów; kopie alokatora puli współdzielą tę samą pulę.
+     */
+    explicit AVLTree(const Allocator& alloc) : root(nullptr), alloc(alloc), allocLock(nullptr) {}
+
+    /**
+     * @brief Konstruktor AVLTree z podanym porządkiem elementów.
+     * @param comp Komparator wyznaczający porządek w drzewie.
+     * @param alloc Alokator węzłów.
+     */
+    explicit AVLTree(const Compare& comp, const Allocator& alloc = Allocator())
+        : root(nullptr), comp(comp), alloc(alloc), allocLock(nullptr) {}
+
+    /**
+     * @brief Konstruktor AVLTree z podanym obserwatorem zmian.
+     * @param observer Obserwator wywoływany przy rotacjach, wstawieniach i usunięciach.
+     * @param comp Komparator wyznaczający porządek w drzewie.
+     * @param alloc Alokator węzłów.
+     */
+    explicit AVLTree(const Observer& observer, const Compare& comp = Compare(),
+                     const Allocator& alloc = Allocator())
+        : root(nullptr), comp(comp), alloc(alloc), allocLock(nullptr), observer(observer) {}
+
+    /**
+     * @brief Buduje idealnie zrównoważone drzewo z posortowanego zakresu w czasie O(n).
+     *
+     * Elementy są umieszczane bezpośrednio na swoich miejscach, a wysokości
+     * i rozmiary poddrzew ustawiane są od razu, bez żadnych rotacji.
+     *
+     * @param first Początek zakresu wartości ściśle rosnących.
+     * @param last Koniec zakresu.
+     * @param checkSorted Czy sprawdzić, że zakres jest ściśle rosnący.
+     * @param alloc Alokator węzłów nowego drzewa.
+     * @return Nowe drzewo AVL zawierające elementy zakresu.
+     * @throws std::invalid_argument Jeśli checkSorted jest ustawione, a zakres nie jest ściśle rosnący.
+     */
+    template <typename ForwardIt>
+    static AVLTree build_from_sorted(ForwardIt first, ForwardIt last, bool checkSorted = false,
+                                     const Allocator& alloc = Allocator()) {
+        AVLTree tree(alloc);
+        if (checkSorted && !isStrictlyIncreasing(first, last, tree.comp)) {
+            throw std::invalid_argument("Zakres nie jest ściśle rosnący. Nie można wykonać build_from_sorted().");
+        }
+        tree.root = tree.buildBalanced(first, static_cast<std::size_t>(std::distance(first, last)));
+        return tree;
+    }
 
     /**
      * @brief Destruktor AVLTree.
      * Usuwa całą strukturę drzewa AVL.
      */
     ~AVLTree() {
-        root = nullptr;
+        clear();
     }
 
     /**
@@ -60,13 +225,29 @@ public:
      *
      * @param other Obiekt AVLTree do skopiowania.
      */
-    AVLTree(const AVLTree &other) {
-        if (other.root == nullptr) {
-            root = nullptr;
-        } else {
-            root = new AVLNode<T>(other.root->value);
-            copyTree(root, other.root);
-        }
+    AVLTree(const AVLTree &other)
+        : root(nullptr), comp(other.comp), allocLock(nullptr), observer(other.observer) {
+        root = cloneTree(other.root);
+    }
+
+    /**
+     * @brief Konstruktor przenoszący - przejmuje węzły other w czasie O(1).
+     *
+     * Alokator jest przenoszony razem z węzłami, więc drzewa nie współdzielą puli
+     * i clear() każdego z nich może zwolnić węzły naraz. Przeniesiony uchwyt puli
+     * lub areny zostaje pusty i tworzy nową pulę dopiero przy pierwszym wstawieniu,
+     * więc konstruktor niczego nie przydziela, a other pozostaje pustym, w pełni
+     * używalnym drzewem.
+     *
+     * @param other Drzewo, którego węzły są przejmowane; po operacji jest puste.
+     */
+    AVLTree(AVLTree&& other) noexcept
+        : root(other.root), comp(other.comp), alloc(std::move(other.alloc)), allocLock(nullptr),
+          observer(other.observer) {
+        other.root = nullptr;
+#ifdef AVLTREE_STATS
+        counters.takeFrom(other.counters);
+#endif
     }
 
     /**
@@ -75,369 +256,1723 @@ public:
      * @param other Obiekt AVLTree do skopiowania.
      * @return Referencja do bieżącego obiektu AVLTree.
      *
-     * Funkcja tworzy kopię drzewa AVL "other" i przypisuje ją do aktualnego drzewa.
-     * Sprawdza, czy bieżące drzewo i obiekt do skopiowania to różne instancje,
-     * aby uniknąć zbędnego przepisywania danych.
+     * Drzewo other jest najpierw klonowane węzeł po węźle w czasie O(n), bez żadnych
+     * porównań ani rotacji, do pamięci z alokatora bieżącego drzewa (który zostaje
+     * zachowany). Dopiero potem zwalniane są dotychczasowe węzły - po jednym, bo pula
+     * zawiera już kopię. Jeśli kopiowanie rzuci wyjątek, bieżące drzewo pozostaje
+     * nienaruszone (silna gwarancja).
      */
     AVLTree& operator=(const AVLTree& other) {
         if (this != &other) {
-            // Usuń istniejące drzewo
-            while (root != nullptr) {
-                remove(root->value);
-            }
-
-            // Skopiuj nowe drzewo
-            if (other.root != nullptr) {
-                root = new AVLNode<T>(other.root->value);
-                copyTree(root, other.root);
-            }
+            Compare newComp(other.comp);
+            Observer newObserver(other.observer);
+            Node* copy = cloneTree(other.root);
+            destroyTree(root);
+            root = copy;
+            comp = std::move(newComp);
+            observer = std::move(newObserver);
         }
         return *this;
     }
 
     /**
-     @brief Czyści całe drzewo AVL, usuwając wszystkie węzły.
+     * @brief Przenoszący operator przypisania - zwalnia bieżące węzły i przejmuje węzły other.
+     *
+     * Alokatory są zamieniane, więc other zostaje pustym drzewem z dotychczasowym alokatorem
+     * bieżącego drzewa.
+     * @param other Drzewo, którego węzły są przejmowane; po operacji jest puste.
+     * @return Referencja do bieżącego obiektu AVLTree.
      */
-    void clear() {
-        root=nullptr;
+    AVLTree& operator=(AVLTree&& other) noexcept {
+        if (this != &other) {
+            clear();
+            swap(other);
+#ifdef AVLTREE_STATS
+            // Jak w konstruktorze przenoszącym liczniki przechodzą razem z węzłami
+            counters.takeFrom(other.counters);
+#endif
+        }
+        return *this;
     }
 
     /**
-     * @brief Sprawdza, czy drzewo AVL jest puste.
-     * @return true, jeśli drzewo jest puste; false w przeciwnym wypadku.
+     * @brief Zamienia zawartość dwóch drzew w czasie O(1).
+     *
+     * Wymieniane są także alokatory, więc węzły nadal wracają do swoich pul.
+     * Iteratory pozostają ważne, ale wskazują elementy drugiego drzewa.
+     *
+     * @param other Drzewo, z którym następuje zamiana.
      */
-    bool empty() const {
-        return root == nullptr;
+    void swap(AVLTree& other) noexcept {
+        std::swap(root, other.root);
+        std::swap(comp, other.comp);
+        std::swap(alloc, other.alloc);
+        std::swap(observer, other.observer);
     }
 
-    /**
-     * @brief Zwraca wartość korzenia drzewa AVL.
-     * @return Wartość znajdująca się w korzeniu drzewa AVL.
-     */
-    T& top() {
-        assert(root != nullptr);
-        return root->value;
+    friend void swap(AVLTree& a, AVLTree& b) noexcept {
+        a.swap(b);
     }
 
     /**
-     * @brief Wstawia nową wartość do drzewa AVL.
-     * @param value Wartość do dodania.
-     * @param debug Czy wyświtlać drzewo po każdym kroku.
-     * @return true, jeśli wstawienie się udało.
+     @brief Czyści całe drzewo AVL, usuwając wszystkie węzły.
+
+     Jeśli węzły (wartości i agregaty) nie wymagają destruktora, a alokator potrafi zwolnić wszystkie
+     węzły naraz (niewspółdzielona pula lub arena), operacja zajmuje O(1).
+     W przeciwnym razie węzły są zwalniane iteracyjnie w czasie O(n).
      */
-    bool insert(const T& value, bool debug = false) {
-        if (debug) std::cout << "Wstawiono węzeł: " << value << std::endl;
-        root = insert(root, value, debug);
-        if (debug) display();
-        return true;
+    void clear() {
+        std::size_t count = subtreeSize(root);
+        if (!std::is_trivially_destructible<Node>::value || !alloc.release()) {
+            destroyTree(root);
+        } else {
+            AVL_STAT_ADD(frees, count);
+        }
+        root = nullptr;
     }
 
     /**
-     * @brief Usuwa wartość z drzewa AVL.
-     * @param value Wartość do usunięcia.
-     * @param debug Czy wyświtlać drzewo po każdym kroku.
-     * @return true, jeśli usunięcie się udało.
+     * @brief Dzieli drzewo według klucza w czasie O(log n).
+     *
+     * Po operacji less zawiera elementy mniejsze od key, greater - większe od key,
+     * a bieżące drzewo jest puste. Sam klucz (jeśli występował) jest usuwany.
+     * Dotychczasowa zawartość less i greater jest usuwana, a oba drzewa przejmują
+     * alokator bieżącego drzewa, więc węzły nie są kopiowane.
+     *
+     * @param key Klucz podziału.
+     * @param less Drzewo wynikowe z elementami mniejszymi od key.
+     * @param greater Drzewo wynikowe z elementami większymi od key.
+     * @return true, jeśli klucz występował w drzewie.
      */
-    bool remove(const T& value, bool debug = false) {
-        if (debug) std::cout << "Usuwam węzeł: " << value << std::endl;
-        root = remove(root, value, debug);
-        if (debug) display();
-        return true;
+    bool split(const T& key, AVLTree& less, AVLTree& greater) {
+        assert(&less != &greater);
+        Node* node = root;
+        root = nullptr;
+        less.clear();
+        greater.clear();
+        less.alloc = alloc;
+        greater.alloc = alloc;
+
+        Node* lessRoot;
+        Node* mid;
+        Node* greaterRoot;
+        splitNodes(node, key, lessRoot, mid, greaterRoot);
+        less.root = lessRoot;
+        greater.root = greaterRoot;
+        if (mid) destroyNode(mid);
+        return mid != nullptr;
     }
 
     /**
-     * @brief Znajduje najmniejszą wartość w drzewie AVL.
-     * @return Najmniejsza wartość w drzewie AVL.
+     * @brief Łączy dwa drzewa i klucz rozdzielający w czasie O(|h(left) - h(right)| + 1).
+     *
+     * Wszystkie elementy left muszą być mniejsze od key, a wszystkie elementy right
+     * większe od key. Drzewa left i right są opróżniane; bieżące drzewo może być
+     * jednym z nich. Węzły drzewa z innym alokatorem są najpierw kopiowane.
+     *
+     * @param left Drzewo z elementami mniejszymi od key.
+     * @param key Klucz rozdzielający.
+     * @param right Drzewo z elementami większymi od key.
+     * @throws std::invalid_argument Jeśli klucz nie rozdziela drzew.
      */
-    T find_min() const {
-        if (!root) {
-            throw std::runtime_error("Drzewo jest puste. Nie można znaleźć wartości minimalnej.");
+    void join(AVLTree& left, const T& key, AVLTree& right) {
+        assert(&left != &right);
+        if ((left.root && !comp(maxValueNode(left.root)->value, key)) ||
+            (right.root && !comp(key, minValueNode(right.root)->value))) {
+            throw std::invalid_argument("Klucz nie rozdziela drzew. Nie można wykonać join().");
         }
-        return minValueNode(root)->value;
+        if (this != &left && this != &right) clear();
+        Node* l = adopt(left);
+        Node* r = adopt(right);
+        root = joinNodes(l, createNode(key), r);
     }
 
     /**
-     * @brief Znajduje największą wartość w drzewie AVL.
-     * @return Największa wartość w drzewie AVL.
+     * @brief Łączy dwa drzewa bez klucza rozdzielającego w czasie O(log n).
+     *
+     * Wszystkie elementy left muszą być mniejsze od wszystkich elementów right.
+     * Drzewa left i right są opróżniane; bieżące drzewo może być jednym z nich.
+     *
+     * @param left Drzewo z mniejszymi elementami.
+     * @param right Drzewo z większymi elementami.
+     * @throws std::invalid_argument Jeśli zakresy drzew nachodzą na siebie.
      */
-    T find_max() const {
-        if (!root) {
-            throw std::runtime_error("Drzewo jest puste. Nie można znaleźć wartości maksymalnej.");
+    void join2(AVLTree& left, AVLTree& right) {
+        assert(&left != &right);
+        if (left.root && right.root &&
+            !comp(maxValueNode(left.root)->value, minValueNode(right.root)->value)) {
+            throw std::invalid_argument("Zakresy drzew nachodzą na siebie. Nie można wykonać join2().");
         }
-        return maxValueNode(root)->value;
+        if (this != &left && this != &right) clear();
+        Node* l = adopt(left);
+        Node* r = adopt(right);
+        root = join2Nodes(l, r);
     }
 
     /**
-     * @brief Wyszukuje wartość w drzewie AVL.
-     * @param value Wartość do wyszukiwania.
-     * @return true, jeśli wartość istnieje w drzewie AVL; w przeciwnym razie false.
+     * @brief Dodaje do drzewa wszystkie elementy drzewa other.
+     *
+     * Złożoność O(m log(n/m + 1)), gdzie m i n to rozmiary mniejszego i większego
+     * drzewa. Drzewo other jest opróżniane, a jego węzły trafiają do wyniku.
+     *
+     * @param other Drzewo, którego elementy są dołączane.
      */
-    bool search(const T& value) const {
-        return search(root, value) != nullptr;
+    void set_union(AVLTree& other) {
+        if (&other == this) return;
+        Node* mine = root;
+        root = nullptr;
+        Node* theirs = adopt(other);
+        root = unionNodes(mine, theirs);
     }
 
     /**
-     * @brief Wykonuje przejście preorder drzewa AVL i drukuje wartości.
+     * @brief Pozostawia w drzewie tylko elementy występujące także w other.
+     *
+     * Złożoność O(m log(n/m + 1)). Drzewo other jest opróżniane.
+     *
+     * @param other Drzewo, z którym liczona jest część wspólna.
      */
-    void preorder() const {
-        preorder(root);
-        std::cout << std::endl;
+    void set_intersection(AVLTree& other) {
+        if (&other == this) return;
+        Node* mine = root;
+        root = nullptr;
+        Node* theirs = adopt(other);
+        root = intersectionNodes(mine, theirs);
     }
 
     /**
-     * @brief Wykonuje przejście inorder drzewa AVL i drukuje wartości.
+     * @brief Usuwa z drzewa wszystkie elementy występujące w other.
+     *
+     * Złożoność O(m log(n/m + 1)). Drzewo other jest opróżniane.
+     *
+     * @param other Drzewo z elementami do usunięcia.
      */
-    void inorder() const {
-        inorder(root);
-        std::cout << std::endl;
+    void set_difference(AVLTree& other) {
+        if (&other == this) {
+            clear();
+            return;
+        }
+        Node* mine = root;
+        root = nullptr;
+        Node* theirs = adopt(other);
+        root = differenceNodes(mine, theirs);
     }
 
     /**
-     * @brief Wykonuje przejście postorder drzewa AVL i drukuje wartości.
+     * @brief Wstawia naraz wszystkie wartości zakresu.
+     *
+     * Wartości są sortowane, a następnie rozdzielane rekurencyjnie po drzewie:
+     * środkowa wartość dzieli drzewo operacją split, obie połowy trafiają do swoich
+     * części, a wyniki łączone są przez join. Każde poddrzewo wyważane jest raz,
+     * a koszt to O(m log(n/m + 1)) zamiast O(m log n) dla m pojedynczych wstawień.
+     *
+     * Podstawowa gwarancja wyjątków: gdy kopiowanie wartości lub komparator rzuci
+     * wyjątek, drzewo pozostaje poprawne, zachowuje wszystkie dotychczasowe elementy
+     * i może zawierać część nowych.
+     *
+     * @param first Początek zakresu wartości (w dowolnej kolejności, mogą się powtarzać).
+     * @param last Koniec zakresu.
+     * @return Liczba wartości, których wcześniej nie było w drzewie.
      */
-    void postorder() const {
-        postorder(root);
-        std::cout << std::endl;
+    template <typename InputIt>
+    std::size_t insert_batch(InputIt first, InputIt last) {
+        std::vector<T> values(first, last);
+        sortUnique(values);
+        std::size_t inserted = 0;
+        try {
+            unionRange(root, values.begin(), values.end(), inserted);
+        } catch (...) {
+            if (root) root->up = nullptr;
+            throw;
+        }
+        if (root) root->up = nullptr;
+        return inserted;
     }
 
     /**
-     * @brief Liczy liczbę węzłów w drzewie AVL.
+     * @brief Usuwa naraz wszystkie wartości zakresu.
      *
-     * Metoda rekurencyjnie przechodzi przez wszystkie węzły drzewa i zlicza je.
+     * Działa jak insert_batch, ale części drzewa łączone są przez join2
+     * z pominięciem znalezionych wartości. Nie przydziela nowych węzłów.
+     * Gdy komparator rzuci wyjątek, drzewo pozostaje poprawne, a część wartości
+     * może być już usunięta (podstawowa gwarancja).
      *
-     * @return Liczba węzłów w drzewie.
+     * @param first Początek zakresu wartości (w dowolnej kolejności, mogą się powtarzać).
+     * @param last Koniec zakresu.
+     * @return Liczba usuniętych wartości.
      */
-    int countNodes() const {
-        return countNodes(root);
+    template <typename InputIt>
+    std::size_t erase_batch(InputIt first, InputIt last) {
+        std::vector<T> values(first, last);
+        sortUnique(values);
+        std::size_t erased = 0;
+        try {
+            differenceRange(root, values.begin(), values.end(), erased);
+        } catch (...) {
+            if (root) root->up = nullptr;
+            throw;
+        }
+        if (root) root->up = nullptr;
+        return erased;
     }
 
+    /**
+     * @brief Domyślny próg rozmiaru, poniżej którego operacje równoległe działają sekwencyjnie.
+     */
+    static const std::size_t ParallelCutoff = 4096;
 
     /**
-     * @brief Wykonuje przeszukiwanie drzewa AVL wszerz (BFS) i drukuje wartości.
+     * @brief Równoległa wersja build_from_sorted.
+     *
+     * Pamięć dla wszystkich węzłów jest przydzielana z góry, po kolei, a węzły są
+     * tworzone i łączone równolegle przez ForkJoinPool. Dla typów, których kopiowanie
+     * może rzucić wyjątek, wykonywana jest wersja sekwencyjna.
+     *
+     * @param first Początek zakresu wartości ściśle rosnących.
+     * @param last Koniec zakresu.
+     * @param checkSorted Czy sprawdzić, że zakres jest ściśle rosnący.
+     * @param alloc Alokator węzłów nowego drzewa.
+     * @param cutoff Rozmiar poddrzewa, poniżej którego budowa jest sekwencyjna.
+     * @return Nowe drzewo AVL zawierające elementy zakresu.
+     * @throws std::invalid_argument Jeśli checkSorted jest ustawione, a zakres nie jest ściśle rosnący.
      */
-    void bfs() const {
-        if (!root) return;
-        std::queue<AVLNode<T>*> q;
-        q.push(root);
-        while (!q.empty()) {
-            AVLNode<T>* current = q.front();
-            q.pop();
-            std::cout << current->value << " ";
-            if (current->left) q.push(current->left);
-            if (current->right) q.push(current->right);
+    template <typename RandomIt>
+    static AVLTree parallel_build_from_sorted(RandomIt first, RandomIt last, bool checkSorted = false,
+                                              const Allocator& alloc = Allocator(),
+                                              std::size_t cutoff = ParallelCutoff) {
+        if (!std::is_nothrow_copy_constructible<T>::value) {
+            return build_from_sorted(first, last, checkSorted, alloc);
         }
-        std::cout << std::endl;
+        AVLTree tree(alloc);
+        if (checkSorted && !isStrictlyIncreasing(first, last, tree.comp)) {
+            throw std::invalid_argument("Zakres nie jest ściśle rosnący. Nie można wykonać build_from_sorted().");
+        }
+        std::size_t count = static_cast<std::size_t>(last - first);
+        std::vector<void*> slots = tree.allocateSlots(count);
+        tree.root = tree.parallelBuild(first, slots.data(), count, std::max<std::size_t>(cutoff, 1));
+        return tree;
     }
 
     /**
-    * @brief Pobiera współczynnik równowagi dla węzła zawierającego podaną wartość w drzewie AVL.
-    *
-    * Współczynnik równowagi obliczany jest jako różnica wysokości lewego i prawego poddrzewa
-    * danego węzła. Pozytywny współczynnik oznacza, że lewe poddrzewo jest wyższe, negatywny
-    * współczynnik oznacza, że prawe poddrzewo jest wyższe, a współczynnik równy zero oznacza,
-    * że oba poddrzewa mają tę samą wysokość.
-    *
-    * @tparam T Typ danych przechowywanych w węzłach drzewa AVL.
-    * @param value Wartość, której węzeł ma zostać odnaleziony w drzewie AVL.
-    * @return Współczynnik równowagi dla węzła zawierającego podaną wartość.
-    * @throws std::runtime_error Jeśli wartość nie zostanie znaleziona w drzewie AVL.
-    */
-    int getBalanceFactor(const T& value) const {
-        AVLNode<T>* node = search(root, value);
-        if (!node) throw std::runtime_error("Wartość nie została znaleziona w drzewie AVL");
-        return balanceFactor(node);
+     * @brief Równoległa wersja set_union.
+     *
+     * Lewa i prawa część rekurencji są wykonywane jako niezależne zadania ForkJoinPool,
+     * dopóki łączny rozmiar poddrzew przekracza cutoff.
+     *
+     * @param other Drzewo, którego elementy są dołączane; po operacji jest puste.
+     * @param cutoff Rozmiar, poniżej którego operacja jest sekwencyjna.
+     */
+    void parallel_union(AVLTree& other, std::size_t cutoff = ParallelCutoff) {
+        if (&other == this) return;
+        Node* mine = root;
+        root = nullptr;
+        Node* theirs = adopt(other);
+        ParallelSection section(*this);
+        root = parallelUnion(mine, theirs, cutoff);
     }
 
     /**
-     * @brief Sprawdza, czy drzewo AVL jest poprawne.
-     *
-     * Drzewo jest poprawne, jeśli spełnia poniższe warunki:
-     * - Współczynnik wyważenia dla każdego węzła wynosi -1, 0 lub 1.
-     * - Wszystkie poddrzewa są również poprawnymi drzewami AVL.
-     *
-     * @return true, jeśli drzewo AVL jest poprawne; false w przeciwnym razie.
+     * @brief Równoległa wersja set_intersection.
+     * @param other Drzewo, z którym liczona jest część wspólna; po operacji jest puste.
+     * @param cutoff Rozmiar, poniżej którego operacja jest sekwencyjna.
      */
-    bool isValid() const {
-        return isValid(root);
+    void parallel_intersection(AVLTree& other, std::size_t cutoff = ParallelCutoff) {
+        if (&other == this) return;
+        Node* mine = root;
+        root = nullptr;
+        Node* theirs = adopt(other);
+        ParallelSection section(*this);
+        root = parallelIntersection(mine, theirs, cutoff);
     }
 
+    /**
+     * @brief Równoległa wersja set_difference.
+     * @param other Drzewo z elementami do usunięcia; po operacji jest puste.
+     * @param cutoff Rozmiar, poniżej którego operacja jest sekwencyjna.
+     */
+    void parallel_difference(AVLTree& other, std::size_t cutoff = ParallelCutoff) {
+        if (&other == this) {
+            clear();
+            return;
+        }
+        Node* mine = root;
+        root = nullptr;
+        Node* theirs = adopt(other);
+        ParallelSection section(*this);
+        root = parallelDifference(mine, theirs, cutoff);
+    }
 
     /**
-     * @brief Wyświetla drzewo AVL w formie graficznej w terminalu.
+     * @brief Pozostawia w drzewie tylko elementy spełniające predykat.
+     *
+     * Oba poddrzewa są filtrowane równolegle, a wyniki łączone przez join,
+     * więc praca wynosi O(n). Predykat musi być bezpieczny dla wielu wątków.
+     * Jeśli predykat rzuci wyjątek, wszystkie węzły są zwalniane, drzewo zostaje
+     * puste, a wyjątek jest przekazywany dalej.
+     *
+     * @param pred Predykat; elementy, dla których zwraca false, są usuwane.
+     * @param cutoff Rozmiar poddrzewa, poniżej którego filtrowanie jest sekwencyjne.
      */
-    void display() {
-        display(root, 0);
-        std::cout << std::endl;
-        std::cout << std::endl;
+    template <typename Predicate>
+    void parallel_filter(Predicate pred, std::size_t cutoff = ParallelCutoff) {
+        Node* node = root;
+        root = nullptr;
+        ParallelSection section(*this);
+        root = parallelFilter(node, pred, cutoff);
     }
 
     /**
-     * @brief Oblicza wysokość drzewa AVL.
+     * @brief Równolegle przekształca elementy i łączy wyniki.
      *
-     * @return Wysokość drzewa AVL.
+     * Wyniki są łączone w kolejności rosnącej, więc reduce musi być łączne,
+     * ale nie musi być przemienne. map i reduce muszą być bezpieczne dla wielu wątków.
+     * Drzewo nie jest modyfikowane, więc wyjątek z map lub reduce jest po prostu
+     * przekazywany dalej (po zakończeniu pozostałych zadań).
+     *
+     * @param map Funkcja wywoływana dla każdego elementu.
+     * @param reduce Łączna funkcja łącząca dwa wyniki.
+     * @param identity Element neutralny operacji reduce.
+     * @param cutoff Rozmiar poddrzewa, poniżej którego obliczenia są sekwencyjne.
+     * @return Wynik redukcji (identity dla pustego drzewa).
      */
-    int getHeight() {
-        return height(root);
+    template <typename R, typename Map, typename Reduce>
+    R parallel_map_reduce(Map map, Reduce reduce, R identity, std::size_t cutoff = ParallelCutoff) const {
+        return parallelMapReduce(root, map, reduce, identity, cutoff);
     }
 
-private:
     /**
-     * Wskaźnik do korzenia drzewa AVL.
+     * @brief Sprawdza, czy drzewo AVL jest puste.
+     * @return true, jeśli drzewo jest puste; false w przeciwnym wypadku.
      */
-    AVLNode<T>* root;
+    bool empty() const {
+        return root == nullptr;
+    }
 
     /**
-     * @brief Oblicza wysokość danego węzła w drzewie AVL.
-     * @param node Wskaźnik do węzła, którego wysokość jest obliczana.
-     * @return Wysokość węzła lub 0, jeśli węzeł jest pusty.
+     * @brief Zwraca wartość korzenia drzewa AVL.
+     * @return Wartość znajdująca się w korzeniu drzewa AVL.
      */
-    int height(AVLNode<T>* node) const {
-        return node ? node->height : 0;
+    T& top() {
+        assert(root != nullptr);
+        return root->value;
     }
 
     /**
-     * @brief Wyświetla drzewo AVL w formie graficznej w terminalu.
+     * @brief Wstawia nową wartość do drzewa AVL.
+     * @param value Wartość do dodania.
+     * @return true, jeśli wartość została dodana; false, jeśli już występowała w drzewie.
      */
-    void display(AVLNode<T>* node, int level) {
-        if (node == nullptr) return;
-        display(node->right, level + 1);
-        for (int i = 0; i < level; i++) {
-            std::cout << "   |";
-        }
-        std::cout << "---" << node->value << std::endl;
-        display(node->left, level + 1);
+    bool insert(const T& value) {
+        Node* parent;
+        bool toLeft;
+        if (findInsertPos(value, parent, toLeft)) return false;
+        insertNode(createNode(value), parent, toLeft);
+        return true;
     }
 
     /**
-     * @brief Oblicza współczynnik równowagi dla węzła w drzewie AVL.
-     * @param node Wskaźnik do węzła, dla którego obliczany jest współczynnik równowagi.
-     * @return Różnica wysokości lewego i prawego poddrzewa danego węzła.
+     * @brief Wstawia wartość, przenosząc ją do nowego węzła zamiast kopiować.
+     * @param value Wartość do dodania; jeśli już występuje w drzewie, pozostaje nienaruszona.
+     * @return true, jeśli wartość została dodana; false, jeśli już występowała w drzewie.
      */
-    int balanceFactor(AVLNode<T>* node) const {
-        return node ? height(node->left) - height(node->right) : 0;
+    bool insert(T&& value) {
+        Node* parent;
+        bool toLeft;
+        if (findInsertPos(value, parent, toLeft)) return false;
+        insertNode(createNode(std::move(value)), parent, toLeft);
+        return true;
     }
 
     /**
-     * @brief Aktualizuje wysokość danego węzła na podstawie jego poddrzew.
-     * @param node Wskaźnik do węzła, którego wysokość jest aktualizowana.
+     * @brief Tworzy wartość bezpośrednio w nowym węźle z podanych argumentów.
+     *
+     * Klucz znany jest dopiero po skonstruowaniu wartości, więc węzeł powstaje
+     * przed wyszukaniem miejsca i jest zwalniany, jeśli taka wartość już istnieje.
+     *
+     * @param args Argumenty konstruktora typu T.
+     * @return Iterator na element równy nowej wartości i informacja, czy został wstawiony.
      */
-    void updateHeight(AVLNode<T>* node) const {
-        if (node) {
-            node->height = 1 + std::max(height(node->left), height(node->right));
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        Node* node = createNode(std::forward<Args>(args)...);
+        Node* parent;
+        bool toLeft;
+        Node* existing = findInsertPos(node->value, parent, toLeft);
+        if (existing) {
+            destroyNode(node);
+            return std::make_pair(iterator(existing, &root), false);
         }
+        insertNode(node, parent, toLeft);
+        return std::make_pair(iterator(node, &root), true);
     }
 
     /**
-     * @brief Wykonuje rotację w prawo na danym węźle.
-     * @param y Wskaźnik do węzła, na którym wykonywana jest operacja rotacji.
-     * @param debug Czy wyświetlać komunikat o rotacji.
-     * @return Wskaźnik do nowego korzenia po rotacji.
+     * @brief Wstawia wartość, szukając miejsca od wskazanego elementu zamiast od korzenia.
+     *
+     * Wyszukiwanie z palcem: metoda wspina się od hint po wskaźnikach up tylko do
+     * najwyższego przodka leżącego między hint a nową wartością i dopiero stamtąd
+     * schodzi w dół. Dla hint leżącego blisko liści (np. elementu z poprzedniego
+     * wstawienia) wartość oddalona o d elementów kosztuje O(log d) porównań zamiast
+     * O(log n). Podanie end() zaczyna od największego elementu, więc dopisywanie
+     * rosnących kluczy (np. znaczników czasu) wykonuje stałą liczbę porównań
+     * niezależnie od rozmiaru drzewa.
+     *
+     * @param hint Element bliski nowej wartości, np. iterator zwrócony przez poprzednie wstawienie.
+     * @param value Wartość do dodania.
+     * @return Iterator na wstawiony element lub na element równy value, jeśli już istniał.
      */
-    AVLNode<T>* rotateRight(AVLNode<T>* y, bool debug = false) {
-        AVLNode<T>* x = y->left;
-        AVLNode<T>* T2 = x->right;
-
-        if (debug) std::cout << "Rotacja w prawo węzła: " << y->value << std::endl;
-        x->right = y;
-        y->left = T2;
-
-        updateHeight(y);
-        updateHeight(x);
+    iterator insert(const_iterator hint, const T& value) {
+        Node* parent;
+        bool toLeft;
+        Node* node = findInsertPosNear(fingerNode(hint), value, parent, toLeft);
+        if (node) return iterator(node, &root);
+        node = createNode(value);
+        insertNode(node, parent, toLeft);
+        return iterator(node, &root);
+    }
 
+    iterator insert(const_iterator hint, T&& value) {
+        Node* parent;
+        bool toLeft;
+        Node* node = findInsertPosNear(fingerNode(hint), value, parent, toLeft);
+        if (node) return iterator(node, &root);
+        node = createNode(std::move(value));
+        insertNode(node, parent, toLeft);
+        return iterator(node, &root);
+    }
 
-        return x;
+    /**
+     * @brief Usuwa wartość z drzewa AVL.
+     *
+     * Węzeł jest wyszukiwany jednym zejściem od korzenia. Brak wartości
+     * (także w pustym drzewie) nie jest błędem - metoda zwraca wtedy false.
+     *
+     * @param value Wartość do usunięcia.
+     * @return true, jeśli wartość została usunięta; false, jeśli jej nie było w drzewie.
+     */
+    bool remove(const T& value) {
+        Node* node = search(root, value);
+        if (!node) return false;
+        eraseNode(node);
+        return true;
     }
 
     /**
-     * @brief Wykonuje rotację w lewo na danym węźle.
-     * @param x Wskaźnik do węzła, na którym wykonywana jest operacja rotacji.
-     * @param debug Czy wyświetlać komunikat o rotacji.
-     * @return Wskaźnik do nowego korzenia po rotacji.
+     * @brief Wyszukuje wartość, zaczynając od wskazanego elementu (jak insert(hint, value)).
+     * @param hint Element bliski szukanej wartości; end() oznacza największy element.
+     * @param value Szukana wartość.
+     * @return Iterator na znaleziony element lub end(), jeśli go nie ma.
      */
-    AVLNode<T>* rotateLeft(AVLNode<T>* x, bool debug = false) {
+    iterator find(const_iterator hint, const T& value) const {
+        Node* parent;
+        bool toLeft;
+        return iterator(findInsertPosNear(fingerNode(hint), value, parent, toLeft), &root);
+    }
 
-        AVLNode<T>* y = x->right;
-        AVLNode<T>* T2 = y->left;
+    /**
+     * @brief Usuwa element wskazywany przez iterator.
+     *
+     * Pozostałe iteratory zachowują ważność, ponieważ usuwanie przepina
+     * węzły zamiast kopiować wartości.
+     *
+     * @param pos Iterator na usuwany element (różny od end()).
+     * @return Iterator na element następujący po usuniętym.
+     */
+    iterator erase(iterator pos) {
+        Node* node = pos.getNode();
+        assert(node != nullptr);
+        ++pos;
+        eraseNode(node);
+        return pos;
+    }
+
+    /**
+     * @brief Znajduje najmniejszą wartość w drzewie AVL.
+     * @return Najmniejsza wartość w drzewie AVL.
+     */
+    T find_min() const {
+        if (!root) {
+            throw std::runtime_error("Drzewo jest puste. Nie można znaleźć wartości minimalnej.");
+        }
+        return minValueNode(root)->value;
+    }
+
+    /**
+     * @brief Znajduje największą wartość w drzewie AVL.
+     * @return Największa wartość w drzewie AVL.
+     */
+    T find_max() const {
+        if (!root) {
+            throw std::runtime_error("Drzewo jest puste. Nie można znaleźć wartości maksymalnej.");
+        }
+        return maxValueNode(root)->value;
+    }
+
+    /**
+     * @brief Wyszukuje wartość w drzewie AVL.
+     * @param value Wartość do wyszukiwania.
+     * @return true, jeśli wartość istnieje w drzewie AVL; w przeciwnym razie false.
+     */
+    bool search(const T& value) const {
+        return search(root, value) != nullptr;
+    }
+
+    /**
+     * @brief Zwraca iterator na najmniejszy element drzewa.
+     */
+    iterator begin() const {
+        return iterator(minValueNode(root), &root);
+    }
+
+    /**
+     * @brief Zwraca iterator za ostatnim elementem drzewa.
+     */
+    iterator end() const {
+        return iterator(nullptr, &root);
+    }
+
+    /**
+     * @brief Zwraca iterator odwrotny na największy element drzewa.
+     */
+    reverse_iterator rbegin() const {
+        return reverse_iterator(end());
+    }
+
+    /**
+     * @brief Zwraca iterator odwrotny przed najmniejszym elementem drzewa.
+     */
+    reverse_iterator rend() const {
+        return reverse_iterator(begin());
+    }
+
+    /**
+     * @brief Wyszukuje wartość i zwraca iterator na nią.
+     * @param value Wartość do wyszukania.
+     * @return Iterator na znaleziony element lub end(), jeśli go nie ma.
+     */
+    iterator find(const T& value) const {
+        return iterator(search(root, value), &root);
+    }
+
+    /**
+     * @brief Wyszukuje element równoważny kluczowi innego typu (wymaga przezroczystego Compare).
+     * @param key Klucz porównywalny z elementami drzewa.
+     * @return Iterator na znaleziony element lub end(), jeśli go nie ma.
+     */
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    iterator find(const Key& key) const {
+        return iterator(search(root, key), &root);
+    }
+
+    /**
+     * @brief Zwraca iterator na pierwszy element nie mniejszy niż value.
+     * @param value Wartość graniczna.
+     * @return Iterator na znaleziony element lub end().
+     */
+    iterator lower_bound(const T& value) const {
+        return iterator(lowerBound(value), &root);
+    }
+
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    iterator lower_bound(const Key& key) const {
+        return iterator(lowerBound(key), &root);
+    }
+
+    /**
+     * @brief Zwraca iterator na pierwszy element większy niż value.
+     * @param value Wartość graniczna.
+     * @return Iterator na znaleziony element lub end().
+     */
+    iterator upper_bound(const T& value) const {
+        return iterator(upperBound(value), &root);
+    }
+
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    iterator upper_bound(const Key& key) const {
+        return iterator(upperBound(key), &root);
+    }
+
+    /**
+     * @brief Zwraca zakres elementów równych value.
+     * @param value Wyszukiwana wartość.
+     * @return Para iteratorów [lower_bound(value), upper_bound(value)).
+     */
+    std::pair<iterator, iterator> equal_range(const T& value) const {
+        return std::make_pair(lower_bound(value), upper_bound(value));
+    }
+
+    /**
+     * @brief Liczba wyszukiwań prowadzonych naraz przez search_batch i find_batch.
+     */
+    static constexpr std::size_t BatchWidth = 16;
+
+    /**
+     * @brief Wyszukuje wiele wartości naraz, nakładając na siebie oczekiwanie na pamięć.
+     *
+     * Klucze przetwarzane są grupami po BatchWidth. W każdym kroku wszystkie zejścia
+     * grupy schodzą o jeden poziom, a następny węzeł każdego z nich jest pobierany
+     * z wyprzedzeniem - chybienia w pamięci podręcznej różnych kluczy obsługiwane
+     * są równolegle zamiast jedno po drugim.
+     *
+     * @param first Początek zakresu kluczy (iterator o dostępie swobodnym).
+     * @param last Koniec zakresu kluczy.
+     * @param results Początek zakresu wyników; results[i] = czy i-ty klucz występuje w drzewie.
+     */
+    template <typename RandomIt, typename ResultIt>
+    void search_batch(RandomIt first, RandomIt last, ResultIt results) const {
+        batchSearch(first, static_cast<std::size_t>(last - first),
+                    [&results](std::size_t i, Node* node) { results[i] = node != nullptr; });
+    }
+
+    /**
+     * @brief Wyszukuje wiele wartości naraz i zwraca iteratory na nie.
+     * @param first Początek zakresu kluczy (iterator o dostępie swobodnym).
+     * @param last Koniec zakresu kluczy.
+     * @param results Początek zakresu wyników; results[i] = find(first[i]).
+     */
+    template <typename RandomIt, typename ResultIt>
+    void find_batch(RandomIt first, RandomIt last, ResultIt results) const {
+        batchSearch(first, static_cast<std::size_t>(last - first),
+                    [this, &results](std::size_t i, Node* node) { results[i] = iterator(node, &root); });
+    }
+
+    /**
+     * @brief Wykonuje przejście preorder drzewa AVL i drukuje wartości.
+     */
+    void preorder() const {
+        for_each_preorder(PrintVisitor());
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Wykonuje przejście inorder drzewa AVL i drukuje wartości.
+     */
+    void inorder() const {
+        for_each_inorder(PrintVisitor());
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Wykonuje przejście postorder drzewa AVL i drukuje wartości.
+     */
+    void postorder() const {
+        for_each_postorder(PrintVisitor());
+        std::cout << std::endl;
+    }
+
+    // Przejścia for_each_* nie używają rekurencji, stosu ani kolejki: kolejny węzeł
+    // wyznaczany jest ze wskaźników left, right i up, więc nie przydzielają pamięci
+    // i działają dla drzew dowolnej wielkości. Visitor dostaje const T&; jeśli zwraca
+    // bool, wartość false przerywa przejście. Drzewa nie wolno modyfikować w trakcie.
+
+    /**
+     * @brief Wywołuje visitor dla elementów w kolejności inorder (rosnącej).
+     * @return false, jeśli visitor przerwał przejście; w przeciwnym razie true.
+     */
+    template <typename Visitor>
+    bool for_each_inorder(Visitor visitor) const {
+        for (Node* node = minValueNode(root); node; node = inorderNext(node)) {
+            if (!visit(visitor, node->value)) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Wywołuje visitor dla elementów w kolejności preorder (węzeł, lewe, prawe poddrzewo).
+     * @return false, jeśli visitor przerwał przejście; w przeciwnym razie true.
+     */
+    template <typename Visitor>
+    bool for_each_preorder(Visitor visitor) const {
+        Node* node = root;
+        while (node) {
+            if (!visit(visitor, node->value)) return false;
+            if (node->left) {
+                node = node->left;
+            } else if (node->right) {
+                node = node->right;
+            } else {
+                // Powrót do najbliższego przodka, którego prawe poddrzewo nie zostało jeszcze odwiedzone
+                while (node->up && (node == node->up->right || !node->up->right)) node = node->up;
+                node = node->up ? node->up->right : nullptr;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Wywołuje visitor dla elementów w kolejności postorder (lewe, prawe poddrzewo, węzeł).
+     * @return false, jeśli visitor przerwał przejście; w przeciwnym razie true.
+     */
+    template <typename Visitor>
+    bool for_each_postorder(Visitor visitor) const {
+        Node* node = root ? postorderFirst(root) : nullptr;
+        while (node) {
+            if (!visit(visitor, node->value)) return false;
+            Node* parent = node->up;
+            node = parent && node == parent->left && parent->right ? postorderFirst(parent->right) : parent;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Wywołuje visitor dla elementów poziomami (wszerz), od lewej do prawej.
+     *
+     * Każdy poziom to osobne zejście po wskaźnikach, które pomija poddrzewa zbyt niskie,
+     * by sięgnąć bieżącego poziomu. W drzewie AVL liczba węzłów maleje wykładniczo
+     * w stronę korzenia, więc całe przejście kosztuje O(n) bez kolejki.
+     *
+     * @return false, jeśli visitor przerwał przejście; w przeciwnym razie true.
+     */
+    template <typename Visitor>
+    bool for_each_level(Visitor visitor) const {
+        for (int level = 0; level < height(root); ++level) {
+            Node* node = root;
+            int depth = 0;
+            while (node) {
+                if (depth == level && !visit(visitor, node->value)) return false;
+                // Dziecko jest potrzebne, jeśli jego poddrzewo ma węzły na poziomie level
+                int needed = level - depth;
+                if (needed > 0 && height(node->left) >= needed) {
+                    node = node->left;
+                    ++depth;
+                } else if (needed > 0 && height(node->right) >= needed) {
+                    node = node->right;
+                    ++depth;
+                } else {
+                    Node* next = nullptr;
+                    while (!next && node->up) {
+                        Node* parent = node->up;
+                        --depth;
+                        if (node == parent->left && height(parent->right) >= level - depth) {
+                            next = parent->right;
+                            ++depth;
+                        }
+                        node = parent;
+                    }
+                    node = next;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Liczy liczbę węzłów w drzewie AVL.
+     *
+     * Liczba węzłów odczytywana jest z rozmiaru poddrzewa zapisanego w korzeniu.
+     *
+     * @return Liczba węzłów w drzewie.
+     */
+    int countNodes() const {
+        return static_cast<int>(size());
+    }
+
+    /**
+     * @brief Zwraca liczbę elementów drzewa w czasie O(1).
+     * @return Liczba elementów w drzewie.
+     */
+    std::size_t size() const {
+        return subtreeSize(root);
+    }
+
+    /**
+     * @brief Liczy elementy mniejsze od podanej wartości w czasie O(log n).
+     * @param value Wartość graniczna (nie musi występować w drzewie).
+     * @return Liczba elementów drzewa mniejszych niż value.
+     */
+    std::size_t rank(const T& value) const {
+        std::size_t result = 0;
+        Node* current = root;
+        while (current) {
+            if (comp(current->value, value)) {
+                result += subtreeSize(current->left) + 1;
+                current = current->right;
+            } else {
+                current = current->left;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Zwraca k-ty najmniejszy element drzewa w czasie O(log n).
+     * @param k Indeks elementu w porządku rosnącym, liczony od 0.
+     * @return Referencja do k-tego najmniejszego elementu.
+     * @throws std::out_of_range Jeśli k jest nie mniejsze niż liczba elementów.
+     */
+    const T& select(std::size_t k) const {
+        if (k >= size()) {
+            throw std::out_of_range("Indeks poza zakresem drzewa. Nie można wykonać select().");
+        }
+        Node* current = root;
+        while (true) {
+            std::size_t leftSize = subtreeSize(current->left);
+            if (k < leftSize) {
+                current = current->left;
+            } else if (k == leftSize) {
+                return current->value;
+            } else {
+                k -= leftSize + 1;
+                current = current->right;
+            }
+        }
+    }
+
+
+    /**
+     * @brief Wykonuje przeszukiwanie drzewa AVL wszerz (BFS) i drukuje wartości.
+     */
+    void bfs() const {
+        if (!root) return;
+        for_each_level(PrintVisitor());
+        std::cout << std::endl;
+    }
+
+    /**
+    * @brief Pobiera współczynnik równowagi dla węzła zawierającego podaną wartość w drzewie AVL.
+    *
+    * Współczynnik równowagi obliczany jest jako różnica wysokości lewego i prawego poddrzewa
+    * danego węzła. Pozytywny współczynnik oznacza, że lewe poddrzewo jest wyższe, negatywny
+    * współczynnik oznacza, że prawe poddrzewo jest wyższe, a współczynnik równy zero oznacza,
+    * że oba poddrzewa mają tę samą wysokość.
+    *
+    * @tparam T Typ danych przechowywanych w węzłach drzewa AVL.
+    * @param value Wartość, której węzeł ma zostać odnaleziony w drzewie AVL.
+    * @return Współczynnik równowagi dla węzła zawierającego podaną wartość.
+    * @throws std::runtime_error Jeśli wartość nie zostanie znaleziona w drzewie AVL.
+    */
+    int getBalanceFactor(const T& value) const {
+        Node* node = search(root, value);
+        if (!node) throw std::runtime_error("Wartość nie została znaleziona w drzewie AVL");
+        return balanceFactor(node);
+    }
+
+    /**
+     * @brief Sprawdza, czy drzewo AVL jest poprawne.
+     *
+     * Drzewo jest poprawne, jeśli spełnia poniższe warunki:
+     * - Współczynnik wyważenia dla każdego węzła wynosi -1, 0 lub 1.
+     * - Wszystkie poddrzewa są również poprawnymi drzewami AVL.
+     * - Wartości w kolejności inorder są ściśle rosnące.
+     *
+     * @return true, jeśli drzewo AVL jest poprawne; false w przeciwnym razie.
+     */
+    bool isValid() const {
+        return (!root || !root->up) && isValid(root) && isStrictlyIncreasing(begin(), end(), comp);
+    }
+
+
+    /**
+     * @brief Tworzy niemodyfikowalną kopię drzewa w układzie Eytzingera w czasie O(n).
+     *
+     * Kopia jest niezależna od drzewa - późniejsze zmiany drzewa jej nie dotyczą,
+     * więc po zakończeniu fazy odczytów można ją po prostu wyrzucić.
+     *
+     * @return Obiekt FrozenAVL z elementami drzewa.
+     */
+    FrozenAVL<T, Compare> freeze() const {
+        return FrozenAVL<T, Compare>(begin(), end(), comp);
+    }
+
+    /**
+     * @brief Zwraca raport zużycia pamięci przez węzły.
+     *
+     * totalBytes to suma rozmiarów węzłów; nie obejmuje wyrównania bloków
+     * ani zapasu trzymanego przez alokator.
+     */
+    MemoryUsage memory_usage() const {
+        MemoryUsage usage;
+        usage.nodes = size();
+        usage.bytesPerNode = sizeof(Node);
+        usage.overheadPerNode = sizeof(Node) - sizeof(T);
+        usage.totalBytes = usage.nodes * usage.bytesPerNode;
+        return usage;
+    }
+
+    /**
+     * @brief Zwraca agregat polityki Augment z całego drzewa w czasie O(1).
+     */
+    template <typename A = Augment>
+    typename A::value_type aggregate() const {
+        return aggregateOf(root);
+    }
+
+    /**
+     * @brief Zwraca agregat polityki Augment z elementów z przedziału [lo, hi] w czasie O(log n).
+     *
+     * Zejście rozdziela się w najwyższym węźle leżącym w przedziale; dalej lewa ścieżka
+     * dokłada całe prawe poddrzewa elementów nie mniejszych niż lo, a prawa - całe
+     * lewe poddrzewa elementów nie większych niż hi. Składniki łączone są w kolejności
+     * inorder, więc operacja combine nie musi być przemienna.
+     *
+     * @param lo Dolna granica przedziału (lub klucz porównywalny z elementami).
+     * @param hi Górna granica przedziału.
+     * @return Agregat elementów z przedziału; identity(), jeśli przedział jest pusty.
+     */
+    template <typename Key, typename A = Augment>
+    typename A::value_type range_aggregate(const Key& lo, const Key& hi) const {
+        Node* node = root;
+        while (node) {
+            if (comp(node->value, lo)) {
+                node = node->right;
+            } else if (comp(hi, node->value)) {
+                node = node->left;
+            } else {
+                break;
+            }
+        }
+        if (!node) return A::identity();
+
+        // Elementy nie mniejsze niż lo z lewego poddrzewa, składane od prawej
+        typename A::value_type left = A::identity();
+        for (Node* current = node->left; current;) {
+            if (comp(current->value, lo)) {
+                current = current->right;
+            } else {
+                left = A::combine(A::combine(A::lift(current->value), aggregateOf(current->right)), left);
+                current = current->left;
+            }
+        }
+        // Elementy nie większe niż hi z prawego poddrzewa, składane od lewej
+        typename A::value_type right = A::identity();
+        for (Node* current = node->right; current;) {
+            if (comp(hi, current->value)) {
+                current = current->left;
+            } else {
+                right = A::combine(right, A::combine(aggregateOf(current->left), A::lift(current->value)));
+                current = current->right;
+            }
+        }
+        return A::combine(A::combine(left, A::lift(node->value)), right);
+    }
+
+    /**
+     * @brief Wywołuje visitor dla każdego przedziału nachodzącego na [lo, hi] (drzewo przedziałów).
+     *
+     * Wymaga elementów będących parami (początek, koniec) uporządkowanymi po początku
+     * i polityki IntervalMaxEndAugment. Poddrzewa, w których największy koniec leży
+     * przed lo, oraz prawe poddrzewa węzłów zaczynających się za hi są pomijane.
+     * Koszt wynosi O(min(n, (k + 1) log n)) dla k znalezionych przedziałów: O(log n),
+     * gdy nic nie nachodzi na [lo, hi], ale w ogólności nie O(log n + k).
+     *
+     * @param lo Początek szukanego przedziału.
+     * @param hi Koniec szukanego przedziału (włącznie).
+     * @param visitor Funkcja wywoływana dla przedziałów w kolejności rosnących początków.
+     */
+    template <typename K, typename Visitor>
+    void for_each_overlap(const K& lo, const K& hi, Visitor visitor) const {
+        static_assert(std::is_same<Augment, IntervalMaxEndAugment<K> >::value,
+                      "for_each_overlap wymaga polityki IntervalMaxEndAugment");
+        forEachOverlap(root, lo, hi, visitor);
+    }
+
+    /**
+     * @brief Zapisuje drzewo do pliku binarnego (format opisany w AVLsnapshot.h).
+     *
+     * Wartości zapisywane są w kolejności preorder razem z rozmiarami lewych poddrzew,
+     * więc load() odtwarza dokładnie ten sam kształt drzewa, a MappedAVL może
+     * przeszukiwać plik bez wczytywania. Wymaga typu trywialnie kopiowalnego.
+     *
+     * @param path Ścieżka do pliku; istniejący plik jest nadpisywany.
+     * @throws std::runtime_error Jeśli zapis się nie powiódł.
+     * @throws std::length_error Jeśli drzewo ma więcej niż 2^32 - 1 elementów.
+     */
+    void save(const std::string& path) const {
+        static_assert(std::is_trivially_copyable<T>::value, "save() wymaga typu trywialnie kopiowalnego");
+        if (size() > 0xFFFFFFFFu) {
+            throw std::length_error("Zbyt wiele elementów. Nie można wykonać save().");
+        }
+        AVLSnapshotHeader header = makeSnapshotHeader<T>(size());
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        const char zeros[64] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(zeros, static_cast<std::streamsize>(header.valuesOffset - sizeof(header)));
+
+        std::vector<std::uint32_t> leftSizes;
+        leftSizes.reserve(size());
+        std::vector<const Node*> stack;
+        if (root) stack.push_back(root);
+        while (!stack.empty()) {
+            const Node* node = stack.back();
+            stack.pop_back();
+            out.write(reinterpret_cast<const char*>(&node->value), sizeof(T));
+            leftSizes.push_back(static_cast<std::uint32_t>(subtreeSize(node->left)));
+            if (node->right) stack.push_back(node->right);
+            if (node->left) stack.push_back(node->left);
+        }
+        out.write(zeros, static_cast<std::streamsize>(
+            header.leftSizesOffset - header.valuesOffset - size() * sizeof(T)));
+        out.write(reinterpret_cast<const char*>(leftSizes.data()),
+                  static_cast<std::streamsize>(leftSizes.size() * sizeof(std::uint32_t)));
+        out.close();
+        if (!out) {
+            throw std::runtime_error("Błąd zapisu pliku " + path + ". Nie można wykonać save().");
+        }
+    }
+
+    /**
+     * @brief Odtwarza drzewo zapisane przez save() w czasie O(n), bez porównań i rotacji.
+     * @param path Ścieżka do pliku.
+     * @param alloc Alokator węzłów nowego drzewa.
+     * @return Drzewo o tym samym kształcie i zawartości co zapisane.
+     * @throws std::runtime_error Jeśli pliku nie da się odczytać, zapisano w nim inny typ
+     *         albo jego zawartość nie opisuje poprawnego drzewa AVL.
+     */
+    static AVLTree load(const std::string& path, const Allocator& alloc = Allocator()) {
+        static_assert(std::is_trivially_copyable<T>::value, "load() wymaga typu trywialnie kopiowalnego");
+        std::ifstream in(path.c_str(), std::ios::binary | std::ios::ate);
+        std::uint64_t fileSize = in ? static_cast<std::uint64_t>(in.tellg()) : 0;
+        AVLSnapshotHeader header;
+        in.seekg(0);
+        if (fileSize < sizeof(header) || !in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            !checkSnapshotHeader<T>(header, fileSize)) {
+            throw std::runtime_error("Niepoprawny plik " + path + ". Nie można wykonać load().");
+        }
+
+        // Obie tablice wczytywane są jednym odczytem do bufora wyrównanego jak max_align_t
+        std::size_t bytes = static_cast<std::size_t>(
+            header.leftSizesOffset + header.count * sizeof(std::uint32_t) - header.valuesOffset);
+        std::vector<std::max_align_t> buffer(bytes / sizeof(std::max_align_t) + 1);
+        char* data = reinterpret_cast<char*>(buffer.data());
+        in.seekg(static_cast<std::streamoff>(header.valuesOffset));
+        if (!in.read(data, static_cast<std::streamsize>(bytes))) {
+            throw std::runtime_error("Błąd odczytu pliku " + path + ". Nie można wykonać load().");
+        }
+        const T* values = reinterpret_cast<const T*>(data);
+        const std::uint32_t* leftSizes =
+            reinterpret_cast<const std::uint32_t*>(data + (header.leftSizesOffset - header.valuesOffset));
+
+        AVLTree tree(alloc);
+        std::size_t next = 0;
+        tree.root = tree.buildPreorder(values, leftSizes, next, static_cast<std::size_t>(header.count), 0);
+        return tree;
+    }
+
+    /**
+     * @brief Zwraca migawkę statystyk drzewa.
+     *
+     * Liczniki operacji są zbierane tylko w programach skompilowanych z AVLTREE_STATS
+     * (w przeciwnym razie są zerami, a pole enabled ma wartość false). Histogram
+     * głębokości węzłów liczony jest przy każdym wywołaniu w czasie O(n).
+     */
+    AVLStats stats() const {
+        AVLStats result = AVLStats();
+#ifdef AVLTREE_STATS
+        result.enabled = true;
+        counters.copyTo(result);
+#endif
+        std::vector<std::pair<const Node*, std::size_t> > stack;
+        if (root) stack.push_back(std::make_pair(root, std::size_t(0)));
+        while (!stack.empty()) {
+            const Node* node = stack.back().first;
+            std::size_t depth = stack.back().second;
+            stack.pop_back();
+            if (result.depthHistogram.size() <= depth) result.depthHistogram.resize(depth + 1);
+            ++result.depthHistogram[depth];
+            if (node->left) stack.push_back(std::make_pair(node->left, depth + 1));
+            if (node->right) stack.push_back(std::make_pair(node->right, depth + 1));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Zeruje liczniki operacji.
+     */
+    void reset_stats() {
+#ifdef AVLTREE_STATS
+        counters.reset();
+#endif
+    }
+
+    /**
+     * @brief Wyświetla drzewo AVL w formie graficznej w terminalu.
+     * @param out Strumień wyjściowy (domyślnie std::cout).
+     */
+    void display(std::ostream& out = std::cout) const {
+        display(root, 0, out);
+        out << std::endl;
+        out << std::endl;
+    }
+
+    /**
+     * @brief Zwraca kopię uchwytu alokatora węzłów.
+     */
+    Allocator get_allocator() const { return alloc; }
+
+    /**
+     * @brief Zwraca obserwatora zmian drzewa.
+     */
+    Observer& get_observer() { return observer; }
+    const Observer& get_observer() const { return observer; }
+
+    /**
+     * @brief Oblicza wysokość drzewa AVL.
+     *
+     * @return Wysokość drzewa AVL.
+     */
+    int getHeight() {
+        return height(root);
+    }
+
+protected:
+    /**
+     * Wskaźnik do korzenia drzewa AVL.
+     */
+    Node* root;
+
+    /**
+     * Komparator wyznaczający porządek elementów.
+     */
+    Compare comp;
+
+    /**
+     * Polityka przydziału pamięci dla węzłów.
+     */
+    Allocator alloc;
+
+    /**
+     * Muteks chroniący alokator i obserwatora podczas operacji równoległych; poza nimi nullptr.
+     */
+    std::mutex* allocLock;
+
+    /**
+     * Obserwator zmian struktury drzewa.
+     */
+    Observer observer;
+
+#ifdef AVLTREE_STATS
+    /**
+     * Liczniki operacji; metody const także je zwiększają.
+     */
+    mutable AVLCounters counters;
+#endif
+
+    // Na czas operacji równoległej zwalnianie węzłów przechodzi przez muteks
+    struct ParallelSection {
+        AVLTree& tree;
+        std::mutex lock;
+
+        explicit ParallelSection(AVLTree& tree) : tree(tree) { tree.allocLock = &lock; }
+        ~ParallelSection() { tree.allocLock = nullptr; }
+    };
+
+    /**
+     * @brief Pobiera węzeł do pamięci podręcznej z wyprzedzeniem.
+     */
+    static void prefetchNode(Node* node) {
+#if defined(__GNUC__)
+        __builtin_prefetch(node);
+#else
+        (void)node;
+#endif
+    }
+
+    /**
+     * @brief Wspólna implementacja search_batch i find_batch.
+     *
+     * Zejście zakończone (trafienie lub pusty wskaźnik) wypada z grupy,
+     * a pętla kończy się, gdy w grupie nie zostało już żadne aktywne zejście.
+     *
+     * @param keys Początek zakresu kluczy.
+     * @param count Liczba kluczy.
+     * @param emit Wywoływane jako emit(i, węzeł lub nullptr) dla każdego klucza.
+     */
+    template <typename RandomIt, typename Emit>
+    void batchSearch(RandomIt keys, std::size_t count, Emit emit) const {
+        AVL_STAT_ADD(searches, count);
+        if (!root) {
+            for (std::size_t i = 0; i < count; ++i) emit(i, nullptr);
+            return;
+        }
+        Node* current[BatchWidth];
+        std::size_t slot[BatchWidth];
+        for (std::size_t start = 0; start < count; start += BatchWidth) {
+            std::size_t active = std::min(BatchWidth, count - start);
+            for (std::size_t j = 0; j < active; ++j) {
+                current[j] = root;
+                slot[j] = start + j;
+            }
+            while (active > 0) {
+                for (std::size_t j = 0; j < active;) {
+                    Node* node = current[j];
+                    const auto& key = keys[slot[j]];
+                    Node* next = nullptr;
+                    bool found = false;
+                    AVL_STAT(comparisons);
+                    if (comp(key, node->value)) {
+                        next = node->left;
+                    } else if (comp(node->value, key)) {
+                        next = node->right;
+                    } else {
+                        found = true;
+                    }
+                    if (!next) {
+                        emit(slot[j], found ? node : nullptr);
+                        // Zakończone zejście zastępujemy ostatnim aktywnym
+                        --active;
+                        current[j] = current[active];
+                        slot[j] = slot[active];
+                        continue;
+                    }
+                    prefetchNode(next);
+                    current[j] = next;
+                    ++j;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Tworzy nowy węzeł w pamięci pochodzącej z alokatora.
+     * @param args Argumenty konstruktora wartości nowego węzła.
+     * @return Wskaźnik do utworzonego węzła.
+     */
+    template <typename... Args>
+    Node* createNode(Args&&... args) {
+        void* mem = alloc.allocate(sizeof(Node));
+        AVL_STAT(allocations);
+        try {
+            Node* node = new (mem) Node(std::in_place, std::forward<Args>(args)...);
+            updateAggregate(node);
+            return node;
+        } catch (...) {
+            alloc.deallocate(mem, sizeof(Node));
+            AVL_STAT(frees);
+            throw;
+        }
+    }
+
+    /**
+     * @brief Niszczy pojedynczy węzeł i oddaje jego pamięć alokatorowi.
+     * @param node Wskaźnik do niszczonego węzła.
+     */
+    void destroyNode(Node* node) {
+        AVL_STAT(frees);
+        node->~Node();
+        if (allocLock) {
+            std::lock_guard<std::mutex> guard(*allocLock);
+            alloc.deallocate(node, sizeof(Node));
+        } else {
+            alloc.deallocate(node, sizeof(Node));
+        }
+    }
+
+    /**
+     * @brief Niszczy całe poddrzewo bez rekurencji.
+     *
+     * Lewe dzieci są kolejno "obracane" na prawą stronę, dzięki czemu
+     * drzewo zamienia się w listę, którą można zwolnić w jednej pętli.
+     *
+     * @param node Wskaźnik do korzenia niszczonego poddrzewa.
+     */
+    void destroyTree(Node* node) {
+        while (node) {
+            if (node->left) {
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            } else {
+                Node* right = node->right;
+                destroyNode(node);
+                node = right;
+            }
+        }
+    }
+
+    /**
+     * @brief Oblicza wysokość danego węzła w drzewie AVL.
+     * @param node Wskaźnik do węzła, którego wysokość jest obliczana.
+     * @return Wysokość węzła lub 0, jeśli węzeł jest pusty.
+     */
+    int height(Node* node) const {
+        return node ? node->height : 0;
+    }
+
+    /**
+     * @brief Zwraca rozmiar poddrzewa zaczepionego w danym węźle.
+     * @param node Wskaźnik do węzła.
+     * @return Liczba węzłów poddrzewa lub 0, jeśli węzeł jest pusty.
+     */
+    std::size_t subtreeSize(Node* node) const {
+        return node ? node->size : 0;
+    }
+
+    /**
+     * @brief Wyświetla drzewo AVL w formie graficznej w terminalu.
+     */
+    void display(Node* node, int level, std::ostream& out) const {
+        if (node == nullptr) return;
+        display(node->right, level + 1, out);
+        for (int i = 0; i < level; i++) {
+            out << "   |";
+        }
+        out << "---";
+        printValue(out, node->value);
+        out << std::endl;
+        display(node->left, level + 1, out);
+    }
+
+    /**
+     * @brief Oblicza współczynnik równowagi dla węzła w drzewie AVL.
+     * @param node Wskaźnik do węzła, dla którego obliczany jest współczynnik równowagi.
+     * @return Różnica wysokości lewego i prawego poddrzewa danego węzła.
+     */
+    int balanceFactor(Node* node) const {
+        return node ? height(node->left) - height(node->right) : 0;
+    }
+
+    /**
+     * @brief Aktualizuje wysokość danego węzła na podstawie jego poddrzew.
+     * @param node Wskaźnik do węzła, którego wysokość jest aktualizowana.
+     */
+    void updateHeight(Node* node) const {
+        if (node) {
+            node->height = 1 + std::max(height(node->left), height(node->right));
+        }
+    }
+
+    /**
+     * @brief Aktualizuje rozmiar poddrzewa danego węzła na podstawie jego dzieci.
+     *
+     * Rozmiar jest poprawiany po każdej zmianie dzieci węzła, więc tu przeliczany
+     * jest także agregat polityki Augment.
+     *
+     * @param node Wskaźnik do węzła, którego rozmiar jest aktualizowany.
+     */
+    void updateSize(Node* node) const {
+        if (node) {
+            node->size = 1 + subtreeSize(node->left) + subtreeSize(node->right);
+            updateAggregate(node);
+        }
+    }
+
+    /**
+     * @brief Przelicza agregat węzła z agregatów dzieci i własnej wartości.
+     */
+    void updateAggregate(Node* node) const {
+        if constexpr (!std::is_same<Augment, NoAugment>::value) {
+            node->aggregate = Augment::combine(Augment::combine(aggregateOf(node->left), Augment::lift(node->value)),
+                                               aggregateOf(node->right));
+        } else {
+            (void)node;
+        }
+    }
+
+    /**
+     * @brief Zwraca agregat poddrzewa lub element neutralny dla pustego poddrzewa.
+     */
+    template <typename A = Augment>
+    static typename A::value_type aggregateOf(const Node* node) {
+        return node ? node->aggregate : A::identity();
+    }
+
+    /**
+     * @brief Podmienia dziecko węzła parent (lub korzeń, gdy parent jest pusty).
+     *
+     * Gdy parent jest pusty, korzeń drzewa zmieniany jest tylko wtedy, gdy oldChild
+     * był korzeniem - dzięki temu rotacje działają też na odłączonych poddrzewach.
+     *
+     * @param parent Rodzic, którego wskaźnik na dziecko jest zmieniany.
+     * @param oldChild Dotychczasowe dziecko.
+     * @param newChild Nowe dziecko (może być nullptr).
+     */
+    void replaceChild(Node* parent, Node* oldChild, Node* newChild) {
+        if (!parent) {
+            if (root == oldChild) root = newChild;
+        } else if (parent->left == oldChild) {
+            parent->left = newChild;
+        } else {
+            parent->right = newChild;
+        }
+    }
+
+    /**
+     * @brief Zgłasza rotację obserwatorowi.
+     *
+     * Operacje parallel_* wykonują rotacje w wątkach puli, więc wtedy wywołania
+     * są szeregowane muteksem sekcji równoległej - obserwator z własnym stanem
+     * (np. TracingObserver) nie musi być bezpieczny wielowątkowo. NullObserver
+     * nie bierze muteksu.
+     */
+    void notifyRotate(const T& pivot, AVLRotation direction) {
+        if constexpr (!std::is_same<Observer, NullObserver>::value) {
+            if (allocLock) {
+                std::lock_guard<std::mutex> guard(*allocLock);
+                observer.on_rotate(pivot, direction);
+                return;
+            }
+        }
+        observer.on_rotate(pivot, direction);
+    }
+
+    /**
+     * @brief Wykonuje rotację w prawo na danym węźle.
+     *
+     * Rotacja aktualizuje wskaźniki up oraz podpina nowy korzeń poddrzewa
+     * w miejsce y u jego rodzica.
+     *
+     * @param y Wskaźnik do węzła, na którym wykonywana jest operacja rotacji.
+     * @return Wskaźnik do nowego korzenia po rotacji.
+     */
+    Node* rotateRight(Node* y) {
+        Node* x = y->left;
+        Node* T2 = x->right;
+        Node* parent = y->up;
+
+        notifyRotate(y->value, AVLRotation::Right);
+        x->right = y;
+        y->up = x;
+        y->left = T2;
+        if (T2) T2->up = y;
+        x->up = parent;
+        replaceChild(parent, y, x);
+
+        updateHeight(y);
+        updateHeight(x);
+        updateSize(y);
+        updateSize(x);
 
-        if (debug) std::cout << "Rotacja w lewo węzła: " << x->value << std::endl;
+        return x;
+    }
+
+    /**
+     * @brief Wykonuje rotację w lewo na danym węźle.
+     *
+     * Rotacja aktualizuje wskaźniki up oraz podpina nowy korzeń poddrzewa
+     * w miejsce x u jego rodzica.
+     *
+     * @param x Wskaźnik do węzła, na którym wykonywana jest operacja rotacji.
+     * @return Wskaźnik do nowego korzenia po rotacji.
+     */
+    Node* rotateLeft(Node* x) {
+
+        Node* y = x->right;
+        Node* T2 = y->left;
+        Node* parent = x->up;
+
+        notifyRotate(x->value, AVLRotation::Left);
 
         y->left = x;
+        x->up = y;
         x->right = T2;
+        if (T2) T2->up = x;
+        y->up = parent;
+        replaceChild(parent, x, y);
 
         updateHeight(x);
         updateHeight(y);
+        updateSize(x);
+        updateSize(y);
 
         return y;
     }
 
     /**
-     * @brief Wykonuje operację wyważania (rebalansowania) danego węzła w drzewie AVL.
-     * @param node Wskaźnik do węzła, który ma zostać zbalansowany.
-     * @param debug Czy wyświetlać drzewo po każdym kroku.
-     * @return Wskaźnik do potencjalnie nowego węzła po wyważeniu.
+     * @brief Wykonuje operację wyważania (rebalansowania) danego węzła w drzewie AVL.
+     * @param node Wskaźnik do węzła, który ma zostać zbalansowany.
+     * @return Wskaźnik do potencjalnie nowego węzła po wyważeniu.
+     */
+    Node* rebalance(Node* node) {
+
+        if (!node) return nullptr;
+        updateHeight(node);
+        updateSize(node);
+        int balance = balanceFactor(node);
+
+        if (balance > 1 && balanceFactor(node->left) >= 0) {
+            AVL_STAT(singleRotations);
+            return rotateRight(node);
+        }
+
+        if (balance > 1 && balanceFactor(node->left) < 0) {
+            AVL_STAT(doubleRotations);
+            rotateLeft(node->left);
+            return rotateRight(node);
+        }
+
+        if (balance < -1 && balanceFactor(node->right) <= 0) {
+            AVL_STAT(singleRotations);
+            return rotateLeft(node);
+        }
+
+        if (balance < -1 && balanceFactor(node->right) > 0) {
+            AVL_STAT(doubleRotations);
+            rotateRight(node->right);
+            return rotateLeft(node);
+        }
+
+        return node;
+    }
+
+    /**
+     * @brief Podpina nowy węzeł jako dziecko rodzica (lub jako korzeń).
+     * @param node Podpinany węzeł.
+     * @param parent Rodzic nowego węzła; nullptr, jeśli drzewo jest puste.
+     * @param toLeft Czy węzeł ma zostać lewym dzieckiem.
+     */
+    void linkNode(Node* node, Node* parent, bool toLeft) {
+        node->up = parent;
+        if (!parent) {
+            root = node;
+        } else if (toLeft) {
+            parent->left = node;
+        } else {
+            parent->right = node;
+        }
+    }
+
+    /**
+     * @brief Szuka miejsca dla klucza jednym zejściem od korzenia.
+     * @param key Klucz porównywalny z elementami drzewa.
+     * @param parent Zwraca przyszłego rodzica nowego węzła (nullptr dla pustego drzewa).
+     * @param toLeft Zwraca, czy nowy węzeł ma zostać lewym dzieckiem.
+     * @return Węzeł równoważny kluczowi lub nullptr, jeśli klucza nie ma w drzewie.
+     */
+    template <typename Key>
+    Node* findInsertPos(const Key& key, Node*& parent, bool& toLeft) const {
+        parent = nullptr;
+        toLeft = false;
+        AVL_STAT(searches);
+        return descendInsertPos(root, key, parent, toLeft);
+    }
+
+    /**
+     * @brief Szuka miejsca dla klucza, zaczynając od węzła finger (wyszukiwanie z palcem).
+     *
+     * Gdy klucz jest większy od palca, wspinaczka porównuje tylko przodków, do których
+     * wchodzi się z lewego dziecka - tylko oni są więksi od palca. Najwyższy z nich
+     * (albo sam palec), który wciąż jest mniejszy od klucza, wyznacza poddrzewo: klucz
+     * leży w jego prawym poddrzewie, bo górną granicę tego poddrzewa wyznacza pierwszy
+     * przodek większy od klucza. Przypadek klucza mniejszego od palca jest symetryczny.
+     *
+     * @param finger Węzeł startowy; nullptr oznacza zwykłe zejście od korzenia.
+     * @return Węzeł równoważny kluczowi lub nullptr (wtedy parent i toLeft wskazują miejsce).
+     */
+    template <typename Key>
+    Node* findInsertPosNear(Node* finger, const Key& key, Node*& parent, bool& toLeft) const {
+        if (!finger) return findInsertPos(key, parent, toLeft);
+        AVL_STAT(searches);
+        AVL_STAT(comparisons);
+        bool right = comp(finger->value, key);
+        if (!right && !comp(key, finger->value)) return finger;
+        Node* bound = finger;
+        for (Node* child = finger; child->up; child = child->up) {
+            Node* ancestor = child->up;
+            // Przodkowie po drugiej stronie leżą poza przedziałem (palec, klucz) - wystarczy przejść wyżej
+            if ((child == ancestor->left) != right) continue;
+            AVL_STAT(comparisons);
+            if (right ? comp(key, ancestor->value) : comp(ancestor->value, key)) break;
+            if (!(right ? comp(ancestor->value, key) : comp(key, ancestor->value))) return ancestor;
+            bound = ancestor;
+        }
+        parent = bound;
+        toLeft = !right;
+        return descendInsertPos(right ? bound->right : bound->left, key, parent, toLeft);
+    }
+
+    /**
+     * @brief Zwraca węzeł startowy wyszukiwania z palcem: element hint albo największy element dla end().
      */
-    AVLNode<T>* rebalance(AVLNode<T>* node, bool debug = false) {
-
-        if (!node) return nullptr;
-        updateHeight(node);
-        int balance = balanceFactor(node);
-
-        if (balance > 1 && balanceFactor(node->left) >= 0) {
-            if (debug) display();
-            return rotateRight(node, debug);
-                }
-
-        if (balance > 1 && balanceFactor(node->left) < 0) {
-            if (debug) display();
-            node->left = rotateLeft(node->left, debug);
-            if (debug) display();
-            return rotateRight(node, debug);
-                }
-
-        if (balance < -1 && balanceFactor(node->right) <= 0) {
-            if (debug) display();
-            return rotateLeft(node, debug);
-                }
-
-        if (balance < -1 && balanceFactor(node->right) > 0) {
-            if (debug) display();
-            node->right = rotateRight(node->right, debug);
-            if (debug) display();
-            return rotateLeft(node, debug);
-                }
-
+    Node* fingerNode(const_iterator hint) const {
+        return hint.getNode() ? hint.getNode() : maxValueNode(root);
+    }
 
-                return node;
+    /**
+     * @brief Schodzi od węzła current do miejsca klucza; parent i toLeft opisują ostatni krok.
+     */
+    template <typename Key>
+    Node* descendInsertPos(Node* current, const Key& key, Node*& parent, bool& toLeft) const {
+        while (current) {
+            AVL_STAT(comparisons);
+            parent = current;
+            if (comp(key, current->value)) {
+                current = current->left;
+                toLeft = true;
+            } else if (comp(current->value, key)) {
+                current = current->right;
+                toLeft = false;
+            } else {
+                return current;
+            }
         }
+        return nullptr;
+    }
 
     /**
-     * @brief Wstawia nową wartość do drzewa AVL.
+     * @brief Podpina nowy węzeł w miejscu znalezionym przez findInsertPos i wyważa drzewo.
+     * @param node Nowy węzeł.
+     * @param parent Rodzic nowego węzła.
+     * @param toLeft Czy węzeł ma zostać lewym dzieckiem.
+     */
+    void insertNode(Node* node, Node* parent, bool toLeft) {
+        AVL_STAT(updates);
+        linkNode(node, parent, toLeft);
+        retrace(parent);
+        observer.on_insert(*this, node->value);
+    }
+
+    /**
+     * @brief Przywraca równowagę na ścieżce od węzła do korzenia.
      *
-     * Metoda ta rekurencyjnie wstawia podaną wartość do drzewa AVL, zachowując
-     * własność zrównoważenia drzewa. Wartość jest porównywana z bieżącymi
-     * węzłami, aby znaleźć odpowiednie miejsce na jej wstawienie. W przypadku
-     * naruszenia równowagi węzłów, wykonywane są operacje wyważania.
+     * Metoda idzie w górę po wskaźnikach up i wyważa kolejnych przodków.
+     * Gdy wysokość poddrzewa przestaje się zmieniać, wyżej położone węzły
+     * nie mogą stracić równowagi, więc pozostaje już tylko poprawić ich rozmiary.
      *
-     * @param node Wskaźnik do bieżącego węzła, od którego rozpoczyna się
-     *             wyszukiwanie miejsca do wstawienia.
-     * @param value Wartość do dodania do drzewa AVL.
-     * @param debug Czy wyświetlać drzewo po każdym kroku.
-     * @return Wskaźnik do potencjalnie nowego węzła po operacji wstawienia.
+     * @param node Najniższy węzeł, którego poddrzewo uległo zmianie.
      */
-    AVLNode<T>* insert(AVLNode<T>* node, const T& value, bool debug = false) {
-        if (!node) {
-            return new AVLNode<T>(value);
+    void retrace(Node* node) {
+        while (node) {
+            AVL_STAT(rebalanceSteps);
+            int oldHeight = node->height;
+            Node* parent = node->up;
+            bool settled = rebalance(node)->height == oldHeight;
+            node = parent;
+            if (settled) break;
         }
+        for (; node; node = node->up) {
+            updateSize(node);
+        }
+    }
 
-        if (value < node->value) {
-            node->left = insert(node->left, value, debug);
-        } else if (value > node->value) {
-            node->right = insert(node->right, value, debug);
+    /**
+     * @brief Odłącza węzeł od drzewa, niszczy go i przywraca równowagę.
+     *
+     * Węzeł z dwojgiem dzieci jest zastępowany swoim następnikiem przez
+     * przepięcie wskaźników, więc wartości nie są kopiowane, a pozostałe
+     * węzły zachowują swoje adresy.
+     *
+     * @param node Usuwany węzeł.
+     */
+    void eraseNode(Node* node) {
+        Node* start;
+        if (node->left && node->right) {
+            Node* successor = minValueNode(node->right);
+            if (successor->up == node) {
+                start = successor;
+            } else {
+                start = successor->up;
+                start->left = successor->right;
+                if (successor->right) successor->right->up = start;
+                successor->right = node->right;
+                node->right->up = successor;
+            }
+            successor->left = node->left;
+            node->left->up = successor;
+            successor->up = node->up;
+            successor->height = node->height;
+            replaceChild(node->up, node, successor);
         } else {
-            return node;
+            Node* child = node->left ? node->left : node->right;
+            start = node->up;
+            if (child) child->up = start;
+            replaceChild(start, node, child);
         }
-
-        return rebalance(node, debug);
+        AVL_STAT(updates);
+        retrace(start);
+        // Odłączony węzeł żyje do końca wywołania, więc obserwator widzi jeszcze jego wartość
+        observer.on_erase(*this, node->value);
+        destroyNode(node);
     }
 
     /**
@@ -448,8 +1983,8 @@ private:
      * @param node Wskaźnik do węzła początkowego.
      * @return Wskaźnik do węzła przechowującego najmniejszą wartość.
      */
-    AVLNode<T>* minValueNode(AVLNode<T>* node) const {
-        AVLNode<T>* current = node;
+    Node* minValueNode(Node* node) const {
+        Node* current = node;
         while (current && current->left) {
             current = current->left;
         }
@@ -463,8 +1998,8 @@ private:
      * @param node Wskaźnik do węzła początkowego.
      * @return Wskaźnik do węzła przechowującego największą wartość.
      */
-    AVLNode<T>* maxValueNode(AVLNode<T>* node) const {
-        AVLNode<T>* current = node;
+    Node* maxValueNode(Node* node) const {
+        Node* current = node;
         while (current && current->right) {
             current = current->right;
         }
@@ -472,126 +2007,111 @@ private:
     }
 
     /**
-     * @brief Usuwa węzeł z podaną wartością z drzewa AVL.
-     *
-     * Metoda usuwa węzeł zawierający podaną wartość, zachowując własność zrównoważenia drzewa AVL.
-     *
-     * @param node Wskaźnik do korzenia poddrzewa, w którym rozpoczęte jest usuwanie.
-     * @param value Wartość do usunięcia.
-     * @param debug Czy wyświetlać drzewo po każdym kroku.
-     * @return Wskaźnik do potencjalnie nowego węzła po usunięciu.
+     * @brief Znajduje pierwszy węzeł, którego wartość nie jest mniejsza niż key.
+     * @param key Wartość graniczna (lub klucz porównywalny z elementami).
+     * @return Wskaźnik do znalezionego węzła; nullptr, jeśli taki nie istnieje.
      */
-    AVLNode<T>* remove(AVLNode<T>* node, const T& value, bool debug = false) {
-        if (!root) {
-            throw std::runtime_error("Drzewo jest puste. Nie można wykonać remove().");
-        }
-
-
-        if (!search(value)) {
-            std::cout << "Nie znaleziono węzła: " << value << std::endl;
-            std::cout << "Nie można usunąć węzła, który nie istnieje!" << std::endl;
-            return node;
+    template <typename Key>
+    Node* lowerBound(const Key& key) const {
+        Node* current = root;
+        Node* result = nullptr;
+        AVL_STAT(searches);
+        while (current) {
+            AVL_STAT(comparisons);
+            if (comp(current->value, key)) {
+                current = current->right;
+            } else {
+                result = current;
+                current = current->left;
+            }
         }
+        return result;
+    }
 
-
-        if (value < node->value) {
-            node->left = remove(node->left, value, debug);
-        } else if (value > node->value) {
-            node->right = remove(node->right, value, debug);
-        } else {
-            if (!node->left || !node->right) {
-                AVLNode<T>* temp = node->left ? node->left : node->right;
-
-                if (!temp) {
-                    temp = node;
-                    node = nullptr;
-                } else {
-                    *node = *temp;
-                }
-
-                delete temp;
+    /**
+     * @brief Znajduje pierwszy węzeł, którego wartość jest większa niż key.
+     * @param key Wartość graniczna (lub klucz porównywalny z elementami).
+     * @return Wskaźnik do znalezionego węzła; nullptr, jeśli taki nie istnieje.
+     */
+    template <typename Key>
+    Node* upperBound(const Key& key) const {
+        Node* current = root;
+        Node* result = nullptr;
+        AVL_STAT(searches);
+        while (current) {
+            AVL_STAT(comparisons);
+            if (comp(key, current->value)) {
+                result = current;
+                current = current->left;
             } else {
-                AVLNode<T>* temp = minValueNode(node->right);
-                node->value = temp->value;
-                node->right = remove(node->right, temp->value, debug);
+                current = current->right;
             }
         }
-
-
-        return rebalance(node, debug);
+        return result;
     }
 
-
     /**
      * @brief Wyszukuje węzeł z podaną wartością w drzewie AVL.
      *
-     * Metoda rekurencyjna, która porównuje wartość w bieżącym węźle z wartościami w poddrzewach,
+     * Metoda schodzi w pętli od podanego węzła, porównując wartość z bieżącym węzłem,
      * dopóki nie znajdzie danego węzła lub napotka pusty wskaźnik.
      *
-     * @param node Wskaźnik do bieżącego węzła w czasie przeszukiwania.
-     * @param value Wartość wyszukiwana.
+     * @param node Wskaźnik do węzła, od którego zaczyna się przeszukiwanie.
+     * @param key Wartość wyszukiwana (lub klucz porównywalny z elementami).
      * @return Wskaźnik do węzła zawierającego podaną wartość; nullptr, jeśli nie znaleziono.
      */
-    AVLNode<T>* search(AVLNode<T>* node, const T& value) const {
-            if (!node || node->value == value) {
-                return node;
-            }
-            if (value < node->value) {
-                return search(node->left, value);
+    template <typename Key>
+    Node* search(Node* node, const Key& key) const {
+        AVL_STAT(searches);
+        while (node) {
+            AVL_STAT(comparisons);
+            if (comp(key, node->value)) {
+                node = node->left;
+            } else if (comp(node->value, key)) {
+                node = node->right;
+            } else {
+                break;
             }
-            return search(node->right, value);
+        }
+        return node;
     }
 
-   /**
-    * @brief Wykonuje przejście preorder po drzewie AVL i drukuje wartości węzłów.
-    *
-    * W kolejności preorder najpierw przetwarzany jest korzeń, potem lewe poddrzewo,
-    * a na końcu prawe poddrzewo.
-    */
-    void preorder(AVLNode<T>* node) const {
-        if (node) {
-            std::cout << node->value << " ";
-            preorder(node->left);
-            preorder(node->right);
+    // Visitor metod preorder(), inorder(), postorder() i bfs() - wypisuje wartość i spację
+    struct PrintVisitor {
+        void operator()(const T& value) const {
+            printValue(std::cout, value);
+            std::cout << " ";
         }
-    }
+    };
 
-   /**
-    * @brief Wykonuje przejście inorder po drzewie AVL i drukuje wartości węzłów.
-    *
-    * W kolejności inorder najpierw przetwarzane jest lewe poddrzewo, potem korzeń,
-    * a na końcu prawe poddrzewo.
-    */
-    void inorder(AVLNode<T>* node) const {
-        if (node) {
-            inorder(node->left);
-            std::cout << node->value << " ";
-            inorder(node->right);
+    /**
+     * @brief Wywołuje visitor; visitor zwracający void nigdy nie przerywa przejścia.
+     */
+    template <typename Visitor>
+    static bool visit(Visitor& visitor, const T& value) {
+        if constexpr (std::is_void<decltype(visitor(value))>::value) {
+            visitor(value);
+            return true;
+        } else {
+            return static_cast<bool>(visitor(value));
         }
     }
 
-   /**
-    * @brief Wykonuje przejście postorder po drzewie AVL i drukuje wartości węzłów.
-    *
-    * W kolejności postorder najpierw przetwarzane jest lewe poddrzewo, potem prawe
-    * poddrzewo, a na końcu korzeń.
-    */
-    void postorder(AVLNode<T>* node) const {
-        if (node) {
-            postorder(node->left);
-            postorder(node->right);
-            std::cout << node->value << " ";
-        }
+    /**
+     * @brief Zwraca następnik węzła w kolejności inorder (nullptr dla ostatniego).
+     */
+    Node* inorderNext(Node* node) const {
+        if (node->right) return minValueNode(node->right);
+        while (node->up && node == node->up->right) node = node->up;
+        return node->up;
     }
 
     /**
-     * @brief Rekurencyjnie liczy węzły w danym poddrzewie.
-     * @param node Wskaźnik na korzeń poddrzewa.
-     * @return Liczba węzłów w poddrzewie.
+     * @brief Zwraca pierwszy węzeł poddrzewa w kolejności postorder - schodzi w lewo, a gdy się nie da, w prawo.
      */
-    int countNodes(AVLNode<T>* node) const {
-        if (!node) return 0;
-        return 1 + countNodes(node->left) + countNodes(node->right);
+    static Node* postorderFirst(Node* node) {
+        while (node->left || node->right) node = node->left ? node->left : node->right;
+        return node;
     }
 
     /**
@@ -604,7 +2124,7 @@ private:
     @param node Wskaźnik na węzeł drzewa, który ma zostać sprawdzony.
     @return true, jeśli drzewo jest poprawne; false w przeciwnym razie.
     */
-    bool isValid(AVLNode<T>* node) const {
+    bool isValid(Node* node) const {
 
         if (!node) return true; // Puste poddrzewo jest zawsze poprawne
 
@@ -616,10 +2136,634 @@ private:
             return false;
         }
 
+        // Zapisana wysokość i wskaźniki na rodzica muszą być spójne z budową drzewa
+        if (node->height != 1 + std::max(height(node->left), height(node->right))) {
+            return false;
+        }
+        if ((node->left && node->left->up != node) || (node->right && node->right->up != node)) {
+            return false;
+        }
+        if (node->size != 1 + subtreeSize(node->left) + subtreeSize(node->right)) {
+            return false;
+        }
+
         // Rekurencyjnie sprawdzaj poprawność lewego i prawego poddrzewa
         return isValid(node->left) && isValid(node->right);
     }
 
+    /**
+     * @brief Sprawdza, czy zakres jest ściśle rosnący.
+     * @param first Początek zakresu.
+     * @param last Koniec zakresu.
+     * @param comp Komparator wyznaczający porządek.
+     * @return true, jeśli każdy element jest mniejszy od następnego.
+     */
+    template <typename ForwardIt>
+    static bool isStrictlyIncreasing(ForwardIt first, ForwardIt last, const Compare& comp) {
+        if (first == last) return true;
+        ForwardIt next = first;
+        for (++next; next != last; ++first, ++next) {
+            if (!comp(*first, *next)) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Buduje zrównoważone poddrzewo z kolejnych count elementów zakresu.
+     *
+     * Lewe poddrzewo dostaje połowę elementów (zaokrągloną w dół), więc
+     * wysokości obu poddrzew różnią się co najwyżej o 1.
+     *
+     * @param it Iterator na pierwszy nieużyty element; po powrocie wskazuje za ostatnim użytym.
+     * @param count Liczba elementów poddrzewa.
+     * @return Wskaźnik do korzenia zbudowanego poddrzewa.
+     */
+    template <typename ForwardIt>
+    Node* buildBalanced(ForwardIt& it, std::size_t count) {
+        if (count == 0) return nullptr;
+        std::size_t leftCount = count / 2;
+        Node* left = buildBalanced(it, leftCount);
+        Node* node;
+        try {
+            node = createNode(*it);
+        } catch (...) {
+            destroyTree(left);
+            throw;
+        }
+        ++it;
+        node->left = left;
+        if (left) left->up = node;
+        try {
+            node->right = buildBalanced(it, count - 1 - leftCount);
+        } catch (...) {
+            destroyTree(node);
+            throw;
+        }
+        if (node->right) node->right->up = node;
+        updateHeight(node);
+        updateSize(node);
+        return node;
+    }
+
+    /**
+     * @brief Odwiedza przedziały poddrzewa nachodzące na [lo, hi] (implementacja for_each_overlap).
+     */
+    template <typename K, typename Visitor>
+    void forEachOverlap(const Node* node, const K& lo, const K& hi, Visitor& visitor) const {
+        if (!node || node->aggregate < lo) return;
+        forEachOverlap(node->left, lo, hi, visitor);
+        if (hi < node->value.first) return;
+        if (!(node->value.second < lo)) visitor(node->value);
+        forEachOverlap(node->right, lo, hi, visitor);
+    }
+
+    /**
+     * @brief Odtwarza poddrzewo z pliku zapisanego przez save().
+     *
+     * Kolejne wartości leżą w kolejności preorder, a leftSizes podaje rozmiar lewego
+     * poddrzewa każdego węzła. Wysokości i rozmiary liczone są od dołu; poddrzewo
+     * niespełniające warunku AVL oznacza uszkodzony plik.
+     *
+     * @param next Indeks kolejnego nieużytego węzła; po powrocie wskazuje za poddrzewem.
+     * @param count Liczba węzłów poddrzewa.
+     * @param depth Głębokość poddrzewa, ograniczająca rekurencję dla uszkodzonych plików.
+     * @return Wskaźnik do korzenia zbudowanego poddrzewa.
+     * @throws std::runtime_error Jeśli dane nie opisują poprawnego drzewa AVL.
+     */
+    Node* buildPreorder(const T* values, const std::uint32_t* leftSizes, std::size_t& next,
+                              std::size_t count, int depth) {
+        if (count == 0) return nullptr;
+        std::size_t index = next++;
+        std::size_t leftCount = leftSizes[index];
+        if (leftCount >= count || depth > AVLSnapshotMaxDepth) {
+            throw std::runtime_error("Uszkodzony plik. Nie można wykonać load().");
+        }
+        Node* node = createNode(values[index]);
+        try {
+            node->left = buildPreorder(values, leftSizes, next, leftCount, depth + 1);
+            node->right = buildPreorder(values, leftSizes, next, count - 1 - leftCount, depth + 1);
+            if (balanceFactor(node) < -1 || balanceFactor(node) > 1) {
+                throw std::runtime_error("Uszkodzony plik. Nie można wykonać load().");
+            }
+        } catch (...) {
+            destroyTree(node);
+            throw;
+        }
+        if (node->left) node->left->up = node;
+        if (node->right) node->right->up = node;
+        updateHeight(node);
+        updateSize(node);
+        return node;
+    }
+
+    /**
+     * @brief Odłącza wszystkie węzły innego drzewa, aby przenieść je do bieżącego.
+     *
+     * Jeśli drzewa mają różne alokatory, węzły są kopiowane do alokatora bieżącego
+     * drzewa, a oryginały zwalniane, bo węzeł musi wrócić do puli, z której pochodzi.
+     *
+     * @param other Drzewo oddające węzły; po operacji jest puste.
+     * @return Korzeń przejętego poddrzewa (z pustym wskaźnikiem up).
+     */
+    Node* adopt(AVLTree& other) {
+        Node* node = other.root;
+        other.root = nullptr;
+        if (node && &other != this && other.alloc != alloc) {
+            Node* copy = cloneTree(node);
+            other.destroyTree(node);
+            node = copy;
+        }
+        if (node) node->up = nullptr;
+        return node;
+    }
+
+    /**
+     * @brief Przywraca równowagę od węzła aż do korzenia jego (pod)drzewa.
+     * @param node Najniższy węzeł wymagający poprawy.
+     * @return Korzeń całego (pod)drzewa po wyważeniu.
+     */
+    Node* rebalanceToTop(Node* node) {
+        Node* top = node;
+        while (node) {
+            Node* parent = node->up;
+            top = rebalance(node);
+            node = parent;
+        }
+        return top;
+    }
+
+    /**
+     * @brief Łączy poddrzewa l i r węzłem k, przy czym l < k < r.
+     *
+     * Jeśli wysokości różnią się o więcej niż 1, k jest wpinany na prawym grzbiecie
+     * wyższego l (lub lewym grzbiecie wyższego r) na poziomie o pasującej wysokości,
+     * a następnie ścieżka jest wyważana w górę. Koszt to O(|h(l) - h(r)| + 1).
+     *
+     * @param l Lewe poddrzewo (może być puste).
+     * @param k Węzeł rozdzielający; jego dotychczasowe dzieci są pomijane.
+     * @param r Prawe poddrzewo (może być puste).
+     * @return Korzeń połączonego poddrzewa.
+     */
+    Node* joinNodes(Node* l, Node* k, Node* r) {
+        if (l) l->up = nullptr;
+        if (r) r->up = nullptr;
+        k->up = nullptr;
+        if (height(l) > height(r) + 1) {
+            Node* c = l;
+            while (height(c->right) > height(r) + 1) c = c->right;
+            attachChildren(k, c->right, r);
+            c->right = k;
+            k->up = c;
+            return rebalanceToTop(c);
+        }
+        if (height(r) > height(l) + 1) {
+            Node* c = r;
+            while (height(c->left) > height(l) + 1) c = c->left;
+            attachChildren(k, l, c->left);
+            c->left = k;
+            k->up = c;
+            return rebalanceToTop(c);
+        }
+        attachChildren(k, l, r);
+        return k;
+    }
+
+    /**
+     * @brief Ustawia dzieci węzła i aktualizuje jego wysokość oraz rozmiar.
+     * @param node Węzeł, któremu przypisywane są dzieci.
+     * @param left Nowe lewe dziecko.
+     * @param right Nowe prawe dziecko.
+     */
+    void attachChildren(Node* node, Node* left, Node* right) {
+        node->left = left;
+        node->right = right;
+        if (left) left->up = node;
+        if (right) right->up = node;
+        updateHeight(node);
+        updateSize(node);
+    }
+
+    /**
+     * @brief Łączy poddrzewa l i r (l < r) bez węzła rozdzielającego.
+     *
+     * Największy węzeł l jest odcinany i służy jako węzeł rozdzielający.
+     *
+     * @return Korzeń połączonego poddrzewa.
+     */
+    Node* join2Nodes(Node* l, Node* r) {
+        if (!l) {
+            if (r) r->up = nullptr;
+            return r;
+        }
+        Node* last;
+        Node* rest = splitLast(l, last);
+        return joinNodes(rest, last, r);
+    }
+
+    /**
+     * @brief Odcina największy węzeł poddrzewa.
+     * @param node Korzeń niepustego poddrzewa.
+     * @param last Zwraca odcięty węzeł.
+     * @return Korzeń pozostałej części poddrzewa.
+     */
+    Node* splitLast(Node* node, Node*& last) {
+        if (!node->right) {
+            last = node;
+            if (node->left) node->left->up = nullptr;
+            return node->left;
+        }
+        Node* rest = splitLast(node->right, last);
+        return joinNodes(node->left, node, rest);
+    }
+
+    /**
+     * @brief Dzieli poddrzewo na elementy mniejsze i większe od klucza.
+     * @param node Korzeń dzielonego poddrzewa.
+     * @param key Klucz podziału.
+     * @param less Zwraca korzeń poddrzewa elementów mniejszych od key.
+     * @param mid Zwraca odłączony węzeł równy key lub nullptr.
+     * @param greater Zwraca korzeń poddrzewa elementów większych od key.
+     */
+    void splitNodes(Node* node, const T& key, Node*& less, Node*& mid, Node*& greater) {
+        if (!node) {
+            less = mid = greater = nullptr;
+            return;
+        }
+        Node* left = node->left;
+        Node* right = node->right;
+        if (comp(key, node->value)) {
+            Node* part;
+            splitNodes(left, key, less, mid, part);
+            greater = joinNodes(part, node, right);
+        } else if (comp(node->value, key)) {
+            Node* part;
+            splitNodes(right, key, part, mid, greater);
+            less = joinNodes(left, node, part);
+        } else {
+            if (left) left->up = nullptr;
+            if (right) right->up = nullptr;
+            less = left;
+            greater = right;
+            mid = node;
+            attachChildren(node, nullptr, nullptr);
+            node->up = nullptr;
+        }
+    }
+
+    /**
+     * @brief Suma dwóch poddrzew; duplikaty z b są zwalniane.
+     * @return Korzeń poddrzewa wynikowego.
+     */
+    Node* unionNodes(Node* a, Node* b) {
+        if (!a) {
+            if (b) b->up = nullptr;
+            return b;
+        }
+        if (!b) {
+            a->up = nullptr;
+            return a;
+        }
+        Node* less;
+        Node* mid;
+        Node* greater;
+        splitNodes(b, a->value, less, mid, greater);
+        if (mid) destroyNode(mid);
+        Node* left = unionNodes(a->left, less);
+        Node* right = unionNodes(a->right, greater);
+        return joinNodes(left, a, right);
+    }
+
+    /**
+     * @brief Część wspólna dwóch poddrzew; pozostałe węzły są zwalniane.
+     * @return Korzeń poddrzewa wynikowego.
+     */
+    Node* intersectionNodes(Node* a, Node* b) {
+        if (!a || !b) {
+            destroyTree(a);
+            destroyTree(b);
+            return nullptr;
+        }
+        Node* less;
+        Node* mid;
+        Node* greater;
+        splitNodes(b, a->value, less, mid, greater);
+        Node* left = intersectionNodes(a->left, less);
+        Node* right = intersectionNodes(a->right, greater);
+        if (mid) {
+            destroyNode(mid);
+            return joinNodes(left, a, right);
+        }
+        destroyNode(a);
+        return join2Nodes(left, right);
+    }
+
+    /**
+     * @brief Sortuje wartości według comp i usuwa równoważne duplikaty.
+     */
+    void sortUnique(std::vector<T>& values) const {
+        std::sort(values.begin(), values.end(), comp);
+        typename std::vector<T>::iterator end = std::unique(values.begin(), values.end(),
+            [this](const T& a, const T& b) { return !comp(a, b) && !comp(b, a); });
+        values.erase(end, values.end());
+    }
+
+    /**
+     * @brief Dzieli posortowany zakres wartości względem wartości węzła.
+     * @param node Węzeł, względem którego dzielony jest zakres.
+     * @param first Początek posortowanego zakresu bez duplikatów.
+     * @param last Koniec zakresu.
+     * @param lessEnd Zwraca koniec części mniejszej od wartości węzła.
+     * @return Początek części większej od wartości węzła (lessEnd + 1, jeśli zakres zawiera wartość węzła).
+     */
+    typename std::vector<T>::iterator partitionRange(Node* node, typename std::vector<T>::iterator first,
+                                                     typename std::vector<T>::iterator last,
+                                                     typename std::vector<T>::iterator& lessEnd) const {
+        lessEnd = std::lower_bound(first, last, node->value, comp);
+        return lessEnd != last && !comp(node->value, *lessEnd) ? lessEnd + 1 : lessEnd;
+    }
+
+    /**
+     * @brief Dodaje do poddrzewa posortowany zakres wartości.
+     *
+     * Zakres dzielony jest wartością korzenia, obie części trafiają rekurencyjnie
+     * do poddrzew, a korzeń jest ponownie łączony z wynikami przez joinNodes - każdy
+     * odwiedzony węzeł wyważany jest więc tylko raz. Do pustego poddrzewa cała
+     * reszta zakresu wstawiana jest od razu jako drzewo zrównoważone. Jeśli
+     * rekurencja rzuci wyjątek, korzeń jest dołączany z powrotem do swoich
+     * poddrzew, więc node zawsze wskazuje poprawne poddrzewo.
+     *
+     * @param node Korzeń poddrzewa (może być pusty); zastępowany korzeniem wyniku.
+     * @param first Początek posortowanego zakresu bez duplikatów.
+     * @param last Koniec zakresu.
+     * @param inserted Zwiększane o liczbę wartości, których nie było w poddrzewie.
+     */
+    void unionRange(Node*& node, typename std::vector<T>::iterator first,
+                    typename std::vector<T>::iterator last, std::size_t& inserted) {
+        if (first == last) return;
+        if (!node) {
+            std::size_t count = static_cast<std::size_t>(last - first);
+            node = buildBalanced(first, count);
+            inserted += count;
+            return;
+        }
+        typename std::vector<T>::iterator lessEnd;
+        typename std::vector<T>::iterator greaterBegin = partitionRange(node, first, last, lessEnd);
+        // Prawe poddrzewo odwiedzimy dopiero po lewym - pobieramy je z wyprzedzeniem
+        if (greaterBegin != last) prefetchNode(node->right);
+        Node* left = node->left;
+        Node* right = node->right;
+        try {
+            unionRange(left, first, lessEnd, inserted);
+            unionRange(right, greaterBegin, last, inserted);
+        } catch (...) {
+            node = joinNodes(left, node, right);
+            throw;
+        }
+        node = joinNodes(left, node, right);
+    }
+
+    /**
+     * @brief Usuwa z poddrzewa wartości posortowanego zakresu.
+     *
+     * Zakres dzielony jest jak w unionRange; węzeł, którego wartość występuje
+     * w zakresie, jest zwalniany, a jego poddrzewa łączone przez join2Nodes.
+     * Węzeł zwalniany jest dopiero po obu wywołaniach rekurencyjnych, więc
+     * wyjątek komparatora pozostawia w node poprawne poddrzewo.
+     *
+     * @param node Korzeń poddrzewa (może być pusty); zastępowany korzeniem wyniku.
+     * @param first Początek posortowanego zakresu bez duplikatów.
+     * @param last Koniec zakresu.
+     * @param erased Zwiększane o liczbę usuniętych wartości.
+     */
+    void differenceRange(Node*& node, typename std::vector<T>::iterator first,
+                         typename std::vector<T>::iterator last, std::size_t& erased) {
+        if (!node || first == last) return;
+        typename std::vector<T>::iterator lessEnd;
+        typename std::vector<T>::iterator greaterBegin = partitionRange(node, first, last, lessEnd);
+        if (greaterBegin != last) prefetchNode(node->right);
+        Node* left = node->left;
+        Node* right = node->right;
+        try {
+            differenceRange(left, first, lessEnd, erased);
+            differenceRange(right, greaterBegin, last, erased);
+        } catch (...) {
+            node = joinNodes(left, node, right);
+            throw;
+        }
+        if (greaterBegin != lessEnd) {
+            destroyNode(node);
+            ++erased;
+            node = join2Nodes(left, right);
+            return;
+        }
+        node = joinNodes(left, node, right);
+    }
+
+    /**
+     * @brief Różnica a \ b dwóch poddrzew; węzły b i usunięte węzły a są zwalniane.
+     * @return Korzeń poddrzewa wynikowego.
+     */
+    Node* differenceNodes(Node* a, Node* b) {
+        if (!a || !b) {
+            destroyTree(b);
+            if (a) a->up = nullptr;
+            return a;
+        }
+        Node* less;
+        Node* mid;
+        Node* greater;
+        splitNodes(a, b->value, less, mid, greater);
+        if (mid) destroyNode(mid);
+        Node* left = differenceNodes(less, b->left);
+        Node* right = differenceNodes(greater, b->right);
+        destroyNode(b);
+        return join2Nodes(left, right);
+    }
+
+    /**
+     * @brief Przydziela z góry pamięć dla count węzłów (parallel_build_from_sorted).
+     *
+     * Przydziały liczone są w statystykach jednym dodaniem, a nie po jednym
+     * z każdego wątku budującego.
+     *
+     * @return Bloki pamięci, po jednym na węzeł; przy wyjątku wszystkie są zwalniane.
+     */
+    std::vector<void*> allocateSlots(std::size_t count) {
+        std::vector<void*> slots;
+        slots.reserve(count);
+        try {
+            for (std::size_t i = 0; i < count; ++i) {
+                slots.push_back(alloc.allocate(sizeof(Node)));
+            }
+        } catch (...) {
+            for (std::size_t i = 0; i < slots.size(); ++i) {
+                alloc.deallocate(slots[i], sizeof(Node));
+            }
+            throw;
+        }
+        AVL_STAT_ADD(allocations, count);
+        return slots;
+    }
+
+    /**
+     * @brief Buduje zrównoważone poddrzewo w przydzielonej z góry pamięci.
+     * @param first Początek posortowanego fragmentu zakresu.
+     * @param slots Pamięć dla węzłów, po jednym bloku na element.
+     * @param count Liczba elementów poddrzewa.
+     * @param cutoff Rozmiar, poniżej którego budowa jest sekwencyjna.
+     * @return Korzeń zbudowanego poddrzewa.
+     */
+    template <typename RandomIt>
+    Node* parallelBuild(RandomIt first, void** slots, std::size_t count, std::size_t cutoff) {
+        if (count == 0) return nullptr;
+        std::size_t leftCount = count / 2;
+        Node* node = new (slots[leftCount]) Node(first[leftCount]);
+        Node* left = nullptr;
+        Node* right = nullptr;
+        if (count > cutoff) {
+            ForkJoinPool::instance().invoke(
+                [&] { left = parallelBuild(first, slots, leftCount, cutoff); },
+                [&] { right = parallelBuild(first + leftCount + 1, slots + leftCount + 1,
+                                            count - 1 - leftCount, cutoff); });
+        } else {
+            left = parallelBuild(first, slots, leftCount, cutoff);
+            right = parallelBuild(first + leftCount + 1, slots + leftCount + 1, count - 1 - leftCount, cutoff);
+        }
+        attachChildren(node, left, right);
+        return node;
+    }
+
+    /**
+     * @brief Równoległa suma poddrzew; poniżej progu wywołuje unionNodes.
+     */
+    Node* parallelUnion(Node* a, Node* b, std::size_t cutoff) {
+        if (!a || !b || a->size + b->size <= cutoff) return unionNodes(a, b);
+        Node* less;
+        Node* mid;
+        Node* greater;
+        splitNodes(b, a->value, less, mid, greater);
+        if (mid) destroyNode(mid);
+        Node* left = nullptr;
+        Node* right = nullptr;
+        ForkJoinPool::instance().invoke(
+            [&] { left = parallelUnion(a->left, less, cutoff); },
+            [&] { right = parallelUnion(a->right, greater, cutoff); });
+        return joinNodes(left, a, right);
+    }
+
+    /**
+     * @brief Równoległa część wspólna poddrzew; poniżej progu wywołuje intersectionNodes.
+     */
+    Node* parallelIntersection(Node* a, Node* b, std::size_t cutoff) {
+        if (!a || !b || a->size + b->size <= cutoff) return intersectionNodes(a, b);
+        Node* less;
+        Node* mid;
+        Node* greater;
+        splitNodes(b, a->value, less, mid, greater);
+        Node* left = nullptr;
+        Node* right = nullptr;
+        ForkJoinPool::instance().invoke(
+            [&] { left = parallelIntersection(a->left, less, cutoff); },
+            [&] { right = parallelIntersection(a->right, greater, cutoff); });
+        if (mid) {
+            destroyNode(mid);
+            return joinNodes(left, a, right);
+        }
+        destroyNode(a);
+        return join2Nodes(left, right);
+    }
+
+    /**
+     * @brief Równoległa różnica poddrzew; poniżej progu wywołuje differenceNodes.
+     */
+    Node* parallelDifference(Node* a, Node* b, std::size_t cutoff) {
+        if (!a || !b || a->size + b->size <= cutoff) return differenceNodes(a, b);
+        Node* less;
+        Node* mid;
+        Node* greater;
+        splitNodes(a, b->value, less, mid, greater);
+        if (mid) destroyNode(mid);
+        Node* left = nullptr;
+        Node* right = nullptr;
+        ForkJoinPool::instance().invoke(
+            [&] { left = parallelDifference(less, b->left, cutoff); },
+            [&] { right = parallelDifference(greater, b->right, cutoff); });
+        destroyNode(b);
+        return join2Nodes(left, right);
+    }
+
+    /**
+     * @brief Filtruje poddrzewo, rozwidlając obliczenia dla poddrzew większych niż cutoff.
+     * @return Korzeń poddrzewa z elementami spełniającymi predykat.
+     */
+    template <typename Predicate>
+    Node* parallelFilter(Node* node, Predicate& pred, std::size_t cutoff) {
+        if (!node) return nullptr;
+        Node* left = nullptr;
+        Node* right = nullptr;
+        bool keep;
+        try {
+            if (node->size > cutoff) {
+                ForkJoinPool::instance().invoke(
+                    [&] { left = parallelFilter(node->left, pred, cutoff); },
+                    [&] { right = parallelFilter(node->right, pred, cutoff); });
+            } else {
+                left = parallelFilter(node->left, pred, cutoff);
+                right = parallelFilter(node->right, pred, cutoff);
+            }
+            keep = pred(node->value);
+        } catch (...) {
+            // Poddrzewo, które rzuciło, posprzątało po sobie; zostają gotowe wyniki i sam węzeł
+            destroyTree(left);
+            destroyTree(right);
+            destroyNode(node);
+            throw;
+        }
+        if (keep) return joinNodes(left, node, right);
+        destroyNode(node);
+        return join2Nodes(left, right);
+    }
+
+    /**
+     * @brief Oblicza map-reduce dla poddrzewa, rozwidlając obliczenia dla dużych poddrzew.
+     */
+    template <typename R, typename Map, typename Reduce>
+    R parallelMapReduce(Node* node, Map& map, Reduce& reduce, const R& identity, std::size_t cutoff) const {
+        if (!node) return identity;
+        R left = identity;
+        R right = identity;
+        if (node->size > cutoff) {
+            ForkJoinPool::instance().invoke(
+                [&] { left = parallelMapReduce(node->left, map, reduce, identity, cutoff); },
+                [&] { right = parallelMapReduce(node->right, map, reduce, identity, cutoff); });
+        } else {
+            left = parallelMapReduce(node->left, map, reduce, identity, cutoff);
+            right = parallelMapReduce(node->right, map, reduce, identity, cutoff);
+        }
+        return reduce(reduce(left, map(node->value)), right);
+    }
+
+    /**
+     * @brief Tworzy kopię poddrzewa w pamięci z alokatora bieżącego drzewa.
+     *
+     * Wysokości są przepisywane, a rozmiary liczone od dołu, więc kopia nie wymaga porównań ani rotacji.
+     * Jeśli kopiowanie wartości rzuci wyjątek, utworzone już węzły są zwalniane.
+     *
+     * @param node Korzeń kopiowanego poddrzewa (może być pusty).
+     * @return Korzeń kopii z pustym wskaźnikiem up.
+     */
+    Node* cloneTree(Node* node) {
+        if (!node) return nullptr;
+        Node* copy = createNode(node->value);
+        try {
+            copyTree(copy, node);
+        } catch (...) {
+            destroyTree(copy);
+            throw;
+        }
+        return copy;
+    }
+
     /**
      * @brief Kopiuje poddrzewo drzewa AVL.
      *
@@ -627,16 +2771,19 @@ private:
      * @param newT Wskaźnik na węzeł docelowy.
      * @param oldT Wskaźnik na węzeł źródłowy.
      */
-    void copyTree(AVLNode<T>*& newT, AVLNode<T>* oldT) {
+    void copyTree(Node*& newT, Node* oldT) {
         if (oldT->left) {
-            newT->left = new AVLNode<T>(oldT->left->value);
+            newT->left = createNode(oldT->left->value);
+            newT->left->up = newT;
             copyTree(newT->left, oldT->left);
         }
         if (oldT->right) {
-            newT->right = new AVLNode<T>(oldT->right->value);
+            newT->right = createNode(oldT->right->value);
+            newT->right->up = newT;
             copyTree(newT->right, oldT->right);
         }
         newT->height = oldT->height;
+        updateSize(newT);
     }
 
 };
@@ -0,0 +1,362 @@
+// CompactAVLtree.h
+#ifndef COMPACTAVLTREE_H
+#define COMPACTAVLTREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "NodePool.h"
+
+// Zwarta odmiana drzewa AVL. Węzły leżą jeden za drugim w jednym wektorze i wskazują
+// na siebie 32-bitowymi indeksami, a wysokość zajmuje jeden bajt obok indeksów.
+// Węzeł nie ma wskaźnika na rodzica ani rozmiaru poddrzewa - ścieżka od korzenia
+// zapamiętywana jest podczas zejścia w tablicy na stosie, więc dla int węzeł zajmuje
+// 16 bajtów zamiast 40. W zamian drzewo nie udostępnia iteratorów ani rank/select.
+template <typename T, typename Compare = std::less<T> >
+class CompactAVLTree {
+public:
+    typedef std::uint32_t Index;
+
+    /**
+     * @brief Indeks oznaczający brak węzła.
+     */
+    static constexpr Index Nil = 0xFFFFFFFFu;
+
+    // Węzeł zwartego drzewa; dzieci wskazywane są indeksami w wektorze węzłów
+    struct Node {
+        T value;
+        Index left, right;
+        std::int8_t height;
+    };
+
+    /**
+     * @brief Konstruktor CompactAVLTree.
+     * Tworzy puste drzewo.
+     * @param comp Komparator wyznaczający porządek elementów.
+     */
+    explicit CompactAVLTree(const Compare& comp = Compare())
+        : root(Nil), freeHead(Nil), count(0), comp(comp) {}
+
+    /**
+     * @brief Rezerwuje miejsce na podaną liczbę węzłów.
+     */
+    void reserve(std::size_t capacity) {
+        nodes.reserve(capacity);
+    }
+
+    /**
+     * @brief Wstawia wartość do drzewa.
+     * @param value Wartość do dodania.
+     * @return true, jeśli wartość została dodana; false, jeśli już istniała.
+     * @throws std::length_error Jeśli liczba węzłów przekroczyłaby zakres indeksów.
+     */
+    bool insert(const T& value) {
+        return insertValue(value);
+    }
+
+    bool insert(T&& value) {
+        return insertValue(std::move(value));
+    }
+
+    /**
+     * @brief Usuwa wartość z drzewa.
+     *
+     * Węzeł z dwojgiem dzieci przejmuje wartość następnika, a zwalniany jest węzeł
+     * następnika. Zwolnione miejsca w wektorze są używane ponownie przy wstawianiu.
+     *
+     * @param value Wartość do usunięcia.
+     * @return true, jeśli wartość została usunięta; false, jeśli jej nie było.
+     */
+    bool remove(const T& value) {
+        Index path[MaxHeight];
+        int depth = 0;
+        Index current = root;
+        while (current != Nil) {
+            path[depth++] = current;
+            const Node& node = nodes[current];
+            if (comp(value, node.value)) {
+                current = node.left;
+            } else if (comp(node.value, value)) {
+                current = node.right;
+            } else {
+                break;
+            }
+        }
+        if (current == Nil) return false;
+
+        Index target = current;
+        if (nodes[target].left != Nil && nodes[target].right != Nil) {
+            Index successor = nodes[target].right;
+            path[depth++] = successor;
+            while (nodes[successor].left != Nil) {
+                successor = nodes[successor].left;
+                path[depth++] = successor;
+            }
+            nodes[target].value = std::move(nodes[successor].value);
+            target = successor;
+        }
+
+        Index child = nodes[target].left != Nil ? nodes[target].left : nodes[target].right;
+        --depth;
+        replaceChild(depth > 0 ? path[depth - 1] : Nil, target, child);
+        releaseNode(target);
+        retrace(path, depth);
+        --count;
+        return true;
+    }
+
+    /**
+     * @brief Wyszukuje wartość w drzewie.
+     * @return true, jeśli wartość istnieje; w przeciwnym razie false.
+     */
+    bool search(const T& value) const {
+        Index current = root;
+        while (current != Nil) {
+            const Node& node = nodes[current];
+            if (comp(value, node.value)) {
+                current = node.left;
+            } else if (comp(node.value, value)) {
+                current = node.right;
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Wywołuje visitor dla każdego elementu w kolejności rosnącej.
+     */
+    template <typename Visitor>
+    void for_each(Visitor visitor) const {
+        Index stack[MaxHeight];
+        int depth = 0;
+        Index current = root;
+        while (current != Nil || depth > 0) {
+            while (current != Nil) {
+                stack[depth++] = current;
+                current = nodes[current].left;
+            }
+            current = stack[--depth];
+            visitor(nodes[current].value);
+            current = nodes[current].right;
+        }
+    }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    int getHeight() const { return height(root); }
+
+    /**
+     * @brief Usuwa wszystkie elementy; pamięć wektora węzłów zostaje zachowana.
+     */
+    void clear() {
+        nodes.clear();
+        root = freeHead = Nil;
+        count = 0;
+    }
+
+    /**
+     * @brief Sprawdza wyważenie, zapisane wysokości i rosnący porządek elementów.
+     */
+    bool isValid() const {
+        const T* previous = nullptr;
+        std::size_t visited = 0;
+        return isValid(root, previous, visited) && visited == count;
+    }
+
+    /**
+     * @brief Zwraca raport zużycia pamięci przez węzły.
+     *
+     * totalBytes obejmuje całą pojemność wektora węzłów, łącznie z rezerwą
+     * i miejscami po usuniętych węzłach.
+     */
+    MemoryUsage memory_usage() const {
+        MemoryUsage usage;
+        usage.nodes = count;
+        usage.bytesPerNode = sizeof(Node);
+        usage.overheadPerNode = sizeof(Node) - sizeof(T);
+        usage.totalBytes = nodes.capacity() * sizeof(Node);
+        return usage;
+    }
+
+private:
+    // Wysokość drzewa AVL o 2^32 węzłach nie przekracza 1.44 * 32, więc ścieżka zawsze się mieści
+    static constexpr int MaxHeight = 64;
+
+    int height(Index node) const {
+        return node == Nil ? 0 : nodes[node].height;
+    }
+
+    void updateHeight(Index node) {
+        nodes[node].height = static_cast<std::int8_t>(
+            1 + std::max(height(nodes[node].left), height(nodes[node].right)));
+    }
+
+    int balanceFactor(Index node) const {
+        return height(nodes[node].left) - height(nodes[node].right);
+    }
+
+    /**
+     * @brief Przydziela węzeł, w pierwszej kolejności z listy zwolnionych miejsc.
+     */
+    template <typename V>
+    Index acquireNode(V&& value) {
+        if (freeHead != Nil) {
+            Index index = freeHead;
+            Node& node = nodes[index];
+            freeHead = node.left;
+            node.value = std::forward<V>(value);
+            node.left = node.right = Nil;
+            node.height = 1;
+            return index;
+        }
+        if (nodes.size() >= Nil) {
+            throw std::length_error("Przekroczono zakres indeksów. Nie można wykonać insert().");
+        }
+        Node node = { std::forward<V>(value), Nil, Nil, 1 };
+        nodes.push_back(std::move(node));
+        return static_cast<Index>(nodes.size() - 1);
+    }
+
+    /**
+     * @brief Odkłada węzeł na listę zwolnionych miejsc (łączoną przez pole left).
+     */
+    void releaseNode(Index node) {
+        nodes[node].left = freeHead;
+        nodes[node].right = Nil;
+        freeHead = node;
+    }
+
+    void replaceChild(Index parent, Index oldChild, Index newChild) {
+        if (parent == Nil) {
+            root = newChild;
+        } else if (nodes[parent].left == oldChild) {
+            nodes[parent].left = newChild;
+        } else {
+            nodes[parent].right = newChild;
+        }
+    }
+
+    Index rotateRight(Index y) {
+        Index x = nodes[y].left;
+        nodes[y].left = nodes[x].right;
+        nodes[x].right = y;
+        updateHeight(y);
+        updateHeight(x);
+        return x;
+    }
+
+    Index rotateLeft(Index x) {
+        Index y = nodes[x].right;
+        nodes[x].right = nodes[y].left;
+        nodes[y].left = x;
+        updateHeight(x);
+        updateHeight(y);
+        return y;
+    }
+
+    Index rebalance(Index node) {
+        updateHeight(node);
+        int balance = balanceFactor(node);
+        if (balance > 1) {
+            if (balanceFactor(nodes[node].left) < 0) nodes[node].left = rotateLeft(nodes[node].left);
+            return rotateRight(node);
+        }
+        if (balance < -1) {
+            if (balanceFactor(nodes[node].right) > 0) nodes[node].right = rotateRight(nodes[node].right);
+            return rotateLeft(node);
+        }
+        return node;
+    }
+
+    /**
+     * @brief Wyważa węzły zapamiętanej ścieżki od dołu do góry.
+     *
+     * Gdy wysokość poddrzewa przestaje się zmieniać, wyżej położone węzły
+     * nie mogą stracić równowagi i pętla się kończy.
+     *
+     * @param path Indeksy węzłów od korzenia w dół.
+     * @param depth Liczba węzłów ścieżki.
+     */
+    void retrace(const Index* path, int depth) {
+        for (int i = depth - 1; i >= 0; --i) {
+            Index node = path[i];
+            int oldHeight = nodes[node].height;
+            Index top = rebalance(node);
+            if (top != node) replaceChild(i > 0 ? path[i - 1] : Nil, node, top);
+            if (nodes[top].height == oldHeight) break;
+        }
+    }
+
+    template <typename V>
+    bool insertValue(V&& value) {
+        Index path[MaxHeight];
+        int depth = 0;
+        Index current = root;
+        bool toLeft = false;
+        while (current != Nil) {
+            path[depth++] = current;
+            const Node& node = nodes[current];
+            if (comp(value, node.value)) {
+                current = node.left;
+                toLeft = true;
+            } else if (comp(node.value, value)) {
+                current = node.right;
+                toLeft = false;
+            } else {
+                return false;
+            }
+        }
+        // acquireNode może przenieść wektor, więc referencje do węzłów bierzemy dopiero potem
+        Index node = acquireNode(std::forward<V>(value));
+        if (depth == 0) {
+            root = node;
+        } else if (toLeft) {
+            nodes[path[depth - 1]].left = node;
+        } else {
+            nodes[path[depth - 1]].right = node;
+        }
+        retrace(path, depth);
+        ++count;
+        return true;
+    }
+
+    bool isValid(Index node, const T*& previous, std::size_t& visited) const {
+        if (node == Nil) return true;
+        int balance = balanceFactor(node);
+        if (balance < -1 || balance > 1) return false;
+        if (nodes[node].height != 1 + std::max(height(nodes[node].left), height(nodes[node].right))) {
+            return false;
+        }
+        if (!isValid(nodes[node].left, previous, visited)) return false;
+        if (previous && !comp(*previous, nodes[node].value)) return false;
+        previous = &nodes[node].value;
+        ++visited;
+        return isValid(nodes[node].right, previous, visited);
+    }
+
+    /**
+     * Indeks korzenia albo Nil dla pustego drzewa.
+     */
+    Index root;
+
+    /**
+     * Początek listy zwolnionych miejsc w wektorze węzłów.
+     */
+    Index freeHead;
+
+    /**
+     * Liczba elementów drzewa.
+     */
+    std::size_t count;
+
+    Compare comp;
+    std::vector<Node> nodes;
+};
+
+#endif // COMPACTAVLTREE_H
@@ -0,0 +1,100 @@
+// ConcurrentAVLtree.h
+#ifndef CONCURRENTAVLTREE_H
+#define CONCURRENTAVLTREE_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "PersistentAVLtree.h"
+
+// Współbieżny zbiór oparty na drzewach AVL, przeznaczony dla wielu piszących naraz.
+// Klucze są rozdzielane funkcją skrótu między niezależne fragmenty (shardy), z których
+// każdy jest drzewem PersistentAVLTree z własnym muteksem piszących. Zapisy do różnych
+// fragmentów nie konkurują ze sobą, a wyszukiwanie czyta atomowo opublikowany korzeń
+// fragmentu i nigdy nie bierze muteksu piszących. Samo atomowe skopiowanie korzenia
+// (shared_ptr) nie jest wolne od blokad - zob. PersistentAVLtree.h.
+template <typename T, typename Hash = std::hash<T> >
+class ConcurrentAVLTree {
+public:
+    /**
+     * @brief Konstruktor ConcurrentAVLTree.
+     * @param shards Liczba niezależnych fragmentów; warto, by była kilka razy większa niż liczba wątków.
+     */
+    explicit ConcurrentAVLTree(std::size_t shards = 64, const Hash& hash = Hash())
+        : shards(shards ? shards : 1), hash(hash) {}
+
+    /**
+     * @brief Wstawia wartość; bezpieczne przy wywołaniach z wielu wątków.
+     * @return true, jeśli wartość została dodana; false, jeśli już istniała.
+     */
+    bool insert(const T& value) {
+        return shardFor(value).insert(value);
+    }
+
+    /**
+     * @brief Usuwa wartość; bezpieczne przy wywołaniach z wielu wątków.
+     * @return true, jeśli wartość została usunięta; false, jeśli jej nie było.
+     */
+    bool remove(const T& value) {
+        return shardFor(value).remove(value);
+    }
+
+    /**
+     * @brief Wyszukuje wartość bez brania muteksu piszących i bez czekania na zapisy.
+     * @return true, jeśli wartość istnieje.
+     */
+    bool search(const T& value) const {
+        return shardFor(value).search(value);
+    }
+
+    /**
+     * @brief Zwraca liczbę elementów.
+     *
+     * Fragmenty odczytywane są po kolei, więc przy równoległych zapisach wynik
+     * jest jedynie przybliżony.
+     */
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < shards.size(); ++i) {
+            total += shards[i].size();
+        }
+        return total;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Sprawdza poprawność wszystkich fragmentów.
+     */
+    bool isValid() const {
+        for (std::size_t i = 0; i < shards.size(); ++i) {
+            if (!shards[i].isValid()) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Usuwa wszystkie elementy.
+     */
+    void clear() {
+        for (std::size_t i = 0; i < shards.size(); ++i) {
+            shards[i].clear();
+        }
+    }
+
+private:
+    PersistentAVLTree<T>& shardFor(const T& value) {
+        return shards[hash(value) % shards.size()];
+    }
+
+    const PersistentAVLTree<T>& shardFor(const T& value) const {
+        return shards[hash(value) % shards.size()];
+    }
+
+    std::vector<PersistentAVLTree<T> > shards;
+    Hash hash;
+};
+
+#endif // CONCURRENTAVLTREE_H
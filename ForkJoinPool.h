@@ -0,0 +1,217 @@
+// ForkJoinPool.h
+#ifndef FORKJOINPOOL_H
+#define FORKJOINPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Pula wątków typu fork-join z kradzieżą zadań (work stealing).
+// Każdy wątek roboczy ma własną kolejkę: nowe zadania odkłada i pobiera z jej końca,
+// a bezczynne wątki kradną zadania z początku kolejek pozostałych wątków.
+// Wątek czekający na zakończenie zadania nie blokuje się, tylko wykonuje inne zadania.
+class ForkJoinPool {
+public:
+    /**
+     * @brief Konstruktor ForkJoinPool.
+     * @param threads Liczba wątków roboczych; 0 oznacza liczbę rdzeni procesora.
+     */
+    explicit ForkJoinPool(unsigned threads = 0) : stop(false), pending(0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        // Ostatnia kolejka przyjmuje zadania od wątków spoza puli
+        for (unsigned i = 0; i <= threads; ++i) {
+            queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+        }
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.push_back(std::thread(&ForkJoinPool::workerLoop, this, i));
+        }
+    }
+
+    /**
+     * @brief Destruktor ForkJoinPool.
+     * Zatrzymuje i dołącza wszystkie wątki robocze.
+     */
+    ~ForkJoinPool() {
+        stop.store(true);
+        sleepCondition.notify_all();
+        for (std::size_t i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+    }
+
+    ForkJoinPool(const ForkJoinPool&) = delete;
+    ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+    /**
+     * @brief Zwraca wspólną pulę z jednym wątkiem na rdzeń procesora.
+     */
+    static ForkJoinPool& instance() {
+        static ForkJoinPool pool;
+        return pool;
+    }
+
+    /**
+     * @brief Zwraca liczbę wątków roboczych.
+     */
+    unsigned size() const {
+        return static_cast<unsigned>(workers.size());
+    }
+
+    /**
+     * @brief Wykonuje f i g, potencjalnie równolegle, i czeka na zakończenie obu.
+     *
+     * Zadanie g jest odkładane do kolejki bieżącego wątku, a f wykonywane od razu.
+     * Jeśli nikt nie ukradł g, wątek wykonuje je sam. Wyjątek rzucony przez
+     * którekolwiek z zadań jest przekazywany dalej po zakończeniu obu.
+     *
+     * @param f Zadanie wykonywane w bieżącym wątku.
+     * @param g Zadanie, które może zostać wykonane przez inny wątek.
+     */
+    template <typename F, typename G>
+    void invoke(F&& f, G&& g) {
+        typedef typename std::remove_reference<G>::type Callable;
+        Task task(&callThunk<Callable>, &g);
+        WorkQueue& queue = *queues[currentQueue()];
+        queue.push(&task);
+        ++pending;
+        sleepCondition.notify_one();
+
+        std::exception_ptr error;
+        try {
+            f();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        if (queue.popBackIf(&task)) {
+            --pending;
+            execute(&task);
+        }
+        while (!task.done.load(std::memory_order_acquire)) {
+            if (!runOne()) std::this_thread::yield();
+        }
+        if (error) std::rethrow_exception(error);
+        if (task.error) std::rethrow_exception(task.error);
+    }
+
+private:
+    struct Task {
+        void (*call)(void*);
+        void* callable;
+        std::atomic<bool> done;
+        std::exception_ptr error;
+
+        Task(void (*call)(void*), void* callable) : call(call), callable(callable), done(false) {}
+    };
+
+    // Kolejka zadań jednego wątku chroniona własnym muteksem
+    class WorkQueue {
+    public:
+        void push(Task* task) {
+            std::lock_guard<std::mutex> guard(lock);
+            tasks.push_back(task);
+        }
+
+        bool popBackIf(Task* task) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (tasks.empty() || tasks.back() != task) return false;
+            tasks.pop_back();
+            return true;
+        }
+
+        Task* popBack() {
+            std::lock_guard<std::mutex> guard(lock);
+            if (tasks.empty()) return nullptr;
+            Task* task = tasks.back();
+            tasks.pop_back();
+            return task;
+        }
+
+        Task* steal() {
+            std::lock_guard<std::mutex> guard(lock);
+            if (tasks.empty()) return nullptr;
+            Task* task = tasks.front();
+            tasks.pop_front();
+            return task;
+        }
+
+    private:
+        std::mutex lock;
+        std::deque<Task*> tasks;
+    };
+
+    template <typename Callable>
+    static void callThunk(void* callable) {
+        (*static_cast<Callable*>(callable))();
+    }
+
+    static void execute(Task* task) {
+        try {
+            task->call(task->callable);
+        } catch (...) {
+            task->error = std::current_exception();
+        }
+        task->done.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Zwraca indeks kolejki bieżącego wątku (kolejka zewnętrzna dla obcych wątków).
+     */
+    std::size_t currentQueue() const {
+        return currentPool() == this ? currentIndex() : queues.size() - 1;
+    }
+
+    static const ForkJoinPool*& currentPool() {
+        static thread_local const ForkJoinPool* pool = nullptr;
+        return pool;
+    }
+
+    static std::size_t& currentIndex() {
+        static thread_local std::size_t index = 0;
+        return index;
+    }
+
+    /**
+     * @brief Wykonuje jedno zadanie z własnej kolejki lub ukradzione innemu wątkowi.
+     * @return true, jeśli jakieś zadanie zostało wykonane.
+     */
+    bool runOne() {
+        std::size_t self = currentQueue();
+        Task* task = queues[self]->popBack();
+        for (std::size_t i = 1; !task && i < queues.size(); ++i) {
+            task = queues[(self + i) % queues.size()]->steal();
+        }
+        if (!task) return false;
+        --pending;
+        execute(task);
+        return true;
+    }
+
+    void workerLoop(std::size_t index) {
+        currentPool() = this;
+        currentIndex() = index;
+        while (!stop.load()) {
+            if (runOne()) continue;
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCondition.wait_for(lock, std::chrono::milliseconds(1),
+                                    [this] { return stop.load() || pending.load() > 0; });
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkQueue> > queues;
+    std::vector<std::thread> workers;
+    std::atomic<bool> stop;
+    std::atomic<long> pending;
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+};
+
+#endif // FORKJOINPOOL_H
@@ -0,0 +1,130 @@
+// FrozenAVLtree.h
+#ifndef FROZENAVLTREE_H
+#define FROZENAVLTREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+// Niemodyfikowalna kopia drzewa przeznaczona dla faz, w których wykonywane jest tylko
+// wyszukiwanie. Elementy zapisane są w jednej tablicy w porządku Eytzingera (BFS):
+// dzieci elementu k leżą pod indeksami 2k i 2k+1, więc zejście nie czyta żadnych
+// wskaźników, a kolejne poziomy drzewa leżą coraz dalej w tej samej tablicy.
+// Wszystkie metody są const, więc obiekt może być przeszukiwany z wielu wątków naraz.
+template <typename T, typename Compare = std::less<T> >
+class FrozenAVL {
+public:
+    /**
+     * @brief Konstruktor FrozenAVL.
+     * Tworzy pusty obiekt.
+     */
+    explicit FrozenAVL(const Compare& comp = Compare()) : count(0), comp(comp) {}
+
+    /**
+     * @brief Buduje układ Eytzingera z zakresu posortowanego ściśle rosnąco w czasie O(n).
+     * @param first Początek zakresu.
+     * @param last Koniec zakresu.
+     * @param comp Komparator wyznaczający porządek elementów.
+     */
+    template <typename ForwardIt>
+    FrozenAVL(ForwardIt first, ForwardIt last, const Compare& comp = Compare())
+        : count(static_cast<std::size_t>(std::distance(first, last))), comp(comp) {
+        if (count == 0) return;
+        // Indeks 0 nie należy do drzewa; wypełnienie pierwszym elementem zwalnia T
+        // z wymogu posiadania konstruktora domyślnego
+        data.assign(count + 1, *first);
+        fill(first, 1);
+    }
+
+    /**
+     * @brief Wyszukuje wartość w tablicy.
+     * @return true, jeśli wartość istnieje; w przeciwnym razie false.
+     */
+    bool search(const T& value) const {
+        return find(value) != nullptr;
+    }
+
+    /**
+     * @brief Zwraca wskaźnik na element równy value.
+     * @return Wskaźnik na element lub nullptr, jeśli go nie ma.
+     */
+    const T* find(const T& value) const {
+        const T* candidate = lower_bound(value);
+        return candidate && !comp(value, *candidate) ? candidate : nullptr;
+    }
+
+    /**
+     * @brief Zwraca wskaźnik na pierwszy element nie mniejszy niż value.
+     *
+     * Pętla zejścia nie zawiera skoków zależnych od porównań: wynik porównania
+     * wybiera dziecko arytmetycznie, a liczba obrotów zależy tylko od rozmiaru.
+     * W każdym kroku pobierany z wyprzedzeniem jest blok potomków kilka poziomów niżej.
+     *
+     * @return Wskaźnik na znaleziony element lub nullptr, jeśli taki nie istnieje.
+     */
+    const T* lower_bound(const T& value) const {
+        if (count == 0) return nullptr;
+        const T* base = data.data();
+        std::size_t k = 1;
+        while (k <= count) {
+            prefetch(base, k * PrefetchStride);
+            k = 2 * k + static_cast<std::size_t>(comp(base[k], value));
+        }
+        // Ostatni skręt w lewo wskazuje wynik: usuwamy końcowe skręty w prawo i ten jeden w lewo
+        k >>= trailingOnes(k) + 1;
+        return k ? base + k : nullptr;
+    }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    // Potomkowie elementu k na poziomie d niżej zajmują ciągły blok od k * 2^d;
+    // wybieramy d tak, aby blok zajmował co najmniej jedną linię pamięci podręcznej
+    static constexpr std::size_t prefetchStride(std::size_t stride = 1) {
+        return stride * sizeof(T) >= 64 ? stride : prefetchStride(stride * 2);
+    }
+
+    static constexpr std::size_t PrefetchStride = prefetchStride();
+
+    static void prefetch(const T* base, std::size_t index) {
+#if defined(__GNUC__)
+        // Adres może wypaść za tablicą - prefetch nie odwołuje się do pamięci, więc jest to bezpieczne
+        __builtin_prefetch(reinterpret_cast<const void*>(
+            reinterpret_cast<std::uintptr_t>(base) + index * sizeof(T)));
+#else
+        (void)base;
+        (void)index;
+#endif
+    }
+
+    static int trailingOnes(std::size_t k) {
+#if defined(__GNUC__)
+        return __builtin_ctzll(~static_cast<unsigned long long>(k));
+#else
+        int ones = 0;
+        for (; k & 1; k >>= 1) ++ones;
+        return ones;
+#endif
+    }
+
+    /**
+     * @brief Rozmieszcza kolejne elementy zakresu w porządku inorder drzewa Eytzingera.
+     */
+    template <typename ForwardIt>
+    void fill(ForwardIt& it, std::size_t k) {
+        if (k > count) return;
+        fill(it, 2 * k);
+        data[k] = *it;
+        ++it;
+        fill(it, 2 * k + 1);
+    }
+
+    std::size_t count;
+    Compare comp;
+    std::vector<T> data;
+};
+
+#endif // FROZENAVLTREE_H
@@ -0,0 +1,258 @@
+// NodePool.h
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+#include <cassert>
+
+// Raport zużycia pamięci przez węzły drzewa
+struct MemoryUsage {
+    std::size_t nodes;           // liczba elementów drzewa
+    std::size_t bytesPerNode;    // rozmiar jednego węzła
+    std::size_t overheadPerNode; // bajty węzła poza samą wartością
+    std::size_t totalBytes;      // pamięć zajęta przez wszystkie węzły
+};
+
+// Pula bloków o stałym rozmiarze. Pamięć pobierana jest dużymi slabami,
+// a zwolnione bloki trafiają na listę wolnych i są używane ponownie.
+class NodePool {
+public:
+    /**
+     * @brief Konstruktor NodePool.
+     * @param blocksPerSlab Liczba bloków mieszczących się w jednym slabie.
+     */
+    explicit NodePool(std::size_t blocksPerSlab = 256)
+        : blockSize(0), blocksPerSlab(blocksPerSlab), freeList(nullptr),
+          cursor(nullptr), limit(nullptr), nextSlab(0) {}
+
+    /**
+     * @brief Destruktor NodePool.
+     * Zwalnia wszystkie slaby bez przechodzenia po pojedynczych blokach.
+     */
+    ~NodePool() {
+        for (std::size_t i = 0; i < slabs.size(); ++i) {
+            ::operator delete(slabs[i]);
+        }
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    /**
+     * @brief Przydziela jeden blok pamięci.
+     * @param size Rozmiar bloku; wszystkie przydziały z jednej puli muszą mieć ten sam rozmiar.
+     * @return Wskaźnik do przydzielonego bloku.
+     */
+    void* allocate(std::size_t size) {
+        if (blockSize == 0) blockSize = roundUp(size);
+        assert(roundUp(size) == blockSize);
+
+        if (freeList) {
+            FreeBlock* block = freeList;
+            freeList = block->next;
+            return block;
+        }
+        if (cursor == limit) nextSlabOrGrow();
+        void* p = cursor;
+        cursor += blockSize;
+        return p;
+    }
+
+    /**
+     * @brief Oddaje blok na listę wolnych bloków.
+     * @param p Wskaźnik do bloku przydzielonego wcześniej przez tę pulę.
+     */
+    void deallocate(void* p) {
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = freeList;
+        freeList = block;
+    }
+
+    /**
+     * @brief Unieważnia wszystkie przydzielone bloki w czasie O(1).
+     * Slaby pozostają w puli i są wykorzystywane przy kolejnych przydziałach.
+     */
+    void reset() {
+        freeList = nullptr;
+        cursor = limit = nullptr;
+        nextSlab = 0;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static std::size_t roundUp(std::size_t size) {
+        const std::size_t align = alignof(std::max_align_t);
+        if (size < sizeof(FreeBlock)) size = sizeof(FreeBlock);
+        return (size + align - 1) / align * align;
+    }
+
+    void nextSlabOrGrow() {
+        if (nextSlab == slabs.size()) {
+            slabs.push_back(static_cast<char*>(::operator new(blockSize * blocksPerSlab)));
+        }
+        cursor = slabs[nextSlab++];
+        limit = cursor + blockSize * blocksPerSlab;
+    }
+
+    std::size_t blockSize;
+    std::size_t blocksPerSlab;
+    FreeBlock* freeList;
+    char* cursor;
+    char* limit;
+    std::size_t nextSlab;
+    std::vector<char*> slabs;
+};
+
+// Arena monotoniczna: bloki wydzielane są przez przesuwanie wskaźnika,
+// a pojedyncze zwolnienia są ignorowane. Pamięć odzyskuje dopiero reset().
+class MonotonicArena {
+public:
+    /**
+     * @brief Konstruktor MonotonicArena.
+     * @param initialBytes Rozmiar pierwszego bloku; kolejne są dwukrotnie większe.
+     */
+    explicit MonotonicArena(std::size_t initialBytes = 4096)
+        : initialBytes(initialBytes), cursor(nullptr), limit(nullptr), nextChunk(0) {}
+
+    ~MonotonicArena() {
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            ::operator delete(chunks[i].data);
+        }
+    }
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    void* allocate(std::size_t size) {
+        const std::size_t align = alignof(std::max_align_t);
+        size = (size + align - 1) / align * align;
+        if (static_cast<std::size_t>(limit - cursor) < size) nextChunkOrGrow(size);
+        void* p = cursor;
+        cursor += size;
+        return p;
+    }
+
+    void deallocate(void*) {}
+
+    /**
+     * @brief Unieważnia wszystkie przydzielone bloki w czasie O(1), zachowując pamięć.
+     */
+    void reset() {
+        cursor = limit = nullptr;
+        nextChunk = 0;
+    }
+
+private:
+    struct Chunk {
+        char* data;
+        std::size_t bytes;
+    };
+
+    void nextChunkOrGrow(std::size_t size) {
+        while (nextChunk < chunks.size() && chunks[nextChunk].bytes < size) ++nextChunk;
+        if (nextChunk == chunks.size()) {
+            std::size_t bytes = chunks.empty() ? initialBytes : chunks.back().bytes * 2;
+            while (bytes < size) bytes *= 2;
+            Chunk chunk = { static_cast<char*>(::operator new(bytes)), bytes };
+            chunks.push_back(chunk);
+        }
+        cursor = chunks[nextChunk].data;
+        limit = cursor + chunks[nextChunk].bytes;
+        ++nextChunk;
+    }
+
+    std::size_t initialBytes;
+    char* cursor;
+    char* limit;
+    std::size_t nextChunk;
+    std::vector<Chunk> chunks;
+};
+
+// Polityka przydziału węzłów oparta na zwykłym new/delete.
+class HeapAllocator {
+public:
+    void* allocate(std::size_t size) { return ::operator new(size); }
+    void deallocate(void* p, std::size_t) { ::operator delete(p); }
+
+    /**
+     * @brief Zbiorcze zwolnienie nie jest obsługiwane - węzły trzeba zwolnić pojedynczo.
+     * @return Zawsze false.
+     */
+    bool release() { return false; }
+
+    bool operator==(const HeapAllocator&) const { return true; }
+    bool operator!=(const HeapAllocator&) const { return false; }
+};
+
+// Polityka przydziału węzłów z puli NodePool. Kopie uchwytu współdzielą tę samą pulę,
+// więc kilka drzew może korzystać z jednej puli i wymieniać się węzłami.
+// Przeniesienie uchwytu nic nie przydziela: przeniesiony uchwyt zostaje pusty i tworzy
+// nową pulę (o tej samej liczbie bloków w slabie) dopiero przy pierwszym przydziale.
+class PoolAllocator {
+public:
+    explicit PoolAllocator(std::size_t blocksPerSlab = 256)
+        : pool(std::make_shared<NodePool>(blocksPerSlab)), blocksPerSlab(blocksPerSlab) {}
+
+    void* allocate(std::size_t size) {
+        if (!pool) pool = std::make_shared<NodePool>(blocksPerSlab);
+        return pool->allocate(size);
+    }
+
+    void deallocate(void* p, std::size_t) { pool->deallocate(p); }
+
+    /**
+     * @brief Zwalnia wszystkie węzły naraz, o ile pula nie jest współdzielona.
+     * @return true, jeśli pula została wyczyszczona (lub jeszcze nie istnieje); false, jeśli korzystają z niej inne drzewa.
+     */
+    bool release() {
+        if (!pool) return true;
+        if (pool.use_count() != 1) return false;
+        pool->reset();
+        return true;
+    }
+
+    bool operator==(const PoolAllocator& other) const { return pool == other.pool; }
+    bool operator!=(const PoolAllocator& other) const { return pool != other.pool; }
+
+private:
+    std::shared_ptr<NodePool> pool;
+    std::size_t blocksPerSlab;
+};
+
+// Polityka przydziału węzłów z areny monotonicznej. Usunięte węzły nie są odzyskiwane
+// aż do wyczyszczenia drzewa, za to przydział to jedynie przesunięcie wskaźnika.
+// Tak jak w PoolAllocator przeniesiony uchwyt tworzy nową arenę dopiero przy pierwszym przydziale.
+class ArenaAllocator {
+public:
+    explicit ArenaAllocator(std::size_t initialBytes = 4096)
+        : arena(std::make_shared<MonotonicArena>(initialBytes)), initialBytes(initialBytes) {}
+
+    void* allocate(std::size_t size) {
+        if (!arena) arena = std::make_shared<MonotonicArena>(initialBytes);
+        return arena->allocate(size);
+    }
+
+    void deallocate(void* p, std::size_t) { arena->deallocate(p); }
+
+    bool release() {
+        if (!arena) return true;
+        if (arena.use_count() != 1) return false;
+        arena->reset();
+        return true;
+    }
+
+    bool operator==(const ArenaAllocator& other) const { return arena == other.arena; }
+    bool operator!=(const ArenaAllocator& other) const { return arena != other.arena; }
+
+private:
+    std::shared_ptr<MonotonicArena> arena;
+    std::size_t initialBytes;
+};
+
+#endif // NODEPOOL_H
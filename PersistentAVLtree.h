@@ -0,0 +1,309 @@
+// PersistentAVLtree.h
+#ifndef PERSISTENTAVLTREE_H
+#define PERSISTENTAVLTREE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+// Niemodyfikowalny węzeł drzewa trwałego. Węzły są współdzielone przez wiele wersji drzewa
+// i zwalniane automatycznie, gdy nie wskazuje na nie już żadna wersja.
+template <typename T>
+struct PersistentAVLNode {
+    typedef std::shared_ptr<const PersistentAVLNode> Ptr;
+
+    const T value;
+    const int height;
+    const std::size_t size;
+    const Ptr left, right;
+
+    /**
+     * @brief Tworzy węzeł o podanej wartości i dzieciach; wysokość i rozmiar liczone są od razu.
+     */
+    PersistentAVLNode(const T& value, const Ptr& left, const Ptr& right)
+        : value(value),
+          height(1 + std::max(left ? left->height : 0, right ? right->height : 0)),
+          size(1 + (left ? left->size : 0) + (right ? right->size : 0)),
+          left(left), right(right) {}
+};
+
+// Trwałe (persistent) drzewo AVL z kopiowaniem przy zapisie.
+// Wstawianie i usuwanie kopiują tylko ścieżkę od korzenia do liścia, a reszta węzłów
+// jest współdzielona z poprzednią wersją. Korzeń publikowany jest atomowo, więc czytelnicy
+// nie biorą muteksu piszących i nie czekają na zakończenie zapisu, a piszący nie czekają
+// na czytelników. Piszący są serializowani muteksem.
+//
+// Atomowe operacje na shared_ptr nie są jednak wolne od blokad: w C++17 korzeń czytany
+// jest przez std::atomic_load, które w libstdc++ bierze jeden z globalnych muteksów
+// wspólnych dla całego procesu, a w C++20 przez std::atomic<std::shared_ptr>, które
+// w libstdc++ używa wewnętrznej blokady wirującej (is_lock_free() zwraca false).
+// Blokada trzymana jest tylko na czas skopiowania wskaźnika korzenia, a samo
+// przeszukiwanie migawki odbywa się już bez synchronizacji.
+template <typename T>
+class PersistentAVLTree {
+public:
+    typedef PersistentAVLNode<T> Node;
+    typedef typename Node::Ptr NodePtr;
+
+    // Niezmienna migawka drzewa. Pozostaje ważna i spójna niezależnie od późniejszych zmian.
+    class Snapshot {
+    public:
+        Snapshot() {}
+        explicit Snapshot(const NodePtr& root) : root(root) {}
+
+        /**
+         * @brief Wyszukuje wartość w migawce.
+         * @return true, jeśli wartość istnieje; w przeciwnym razie false.
+         */
+        bool search(const T& value) const {
+            const Node* node = root.get();
+            while (node) {
+                if (value < node->value) {
+                    node = node->left.get();
+                } else if (node->value < value) {
+                    node = node->right.get();
+                } else {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool empty() const { return !root; }
+        std::size_t size() const { return root ? root->size : 0; }
+        int getHeight() const { return root ? root->height : 0; }
+
+        /**
+         * @brief Zwraca k-ty najmniejszy element migawki (licząc od 0).
+         * @throws std::out_of_range Jeśli k jest nie mniejsze niż liczba elementów.
+         */
+        const T& select(std::size_t k) const {
+            if (k >= size()) {
+                throw std::out_of_range("Indeks poza zakresem drzewa. Nie można wykonać select().");
+            }
+            const Node* node = root.get();
+            while (true) {
+                std::size_t leftSize = node->left ? node->left->size : 0;
+                if (k < leftSize) {
+                    node = node->left.get();
+                } else if (k == leftSize) {
+                    return node->value;
+                } else {
+                    k -= leftSize + 1;
+                    node = node->right.get();
+                }
+            }
+        }
+
+        /**
+         * @brief Wywołuje visitor dla każdego elementu w kolejności rosnącej.
+         */
+        template <typename Visitor>
+        void for_each(Visitor visitor) const {
+            forEach(root.get(), visitor);
+        }
+
+        /**
+         * @brief Sprawdza wyważenie, uporządkowanie i zapisane wysokości migawki.
+         */
+        bool isValid() const {
+            const T* previous = nullptr;
+            return isValid(root.get(), previous);
+        }
+
+    private:
+        template <typename Visitor>
+        static void forEach(const Node* node, Visitor& visitor) {
+            if (!node) return;
+            forEach(node->left.get(), visitor);
+            visitor(node->value);
+            forEach(node->right.get(), visitor);
+        }
+
+        static bool isValid(const Node* node, const T*& previous) {
+            if (!node) return true;
+            int hl = height(node->left);
+            int hr = height(node->right);
+            if (hl - hr < -1 || hl - hr > 1) return false;
+            if (!isValid(node->left.get(), previous)) return false;
+            if (previous && !(*previous < node->value)) return false;
+            previous = &node->value;
+            return isValid(node->right.get(), previous);
+        }
+
+        NodePtr root;
+    };
+
+    /**
+     * @brief Konstruktor PersistentAVLTree.
+     * Tworzy puste drzewo.
+     */
+    PersistentAVLTree() {}
+
+    /**
+     * @brief Konstruktor kopiujący - w czasie O(1) współdzieli bieżącą wersję drzewa other.
+     */
+    PersistentAVLTree(const PersistentAVLTree& other) : root(other.loadRoot()) {}
+
+    /**
+     * @brief Operator przypisania - w czasie O(1) współdzieli bieżącą wersję drzewa other.
+     */
+    PersistentAVLTree& operator=(const PersistentAVLTree& other) {
+        if (this != &other) {
+            NodePtr next = other.loadRoot();
+            std::lock_guard<std::mutex> guard(writeLock);
+            storeRoot(next);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Zwraca niezmienną migawkę bieżącej wersji drzewa w czasie O(1).
+     */
+    Snapshot snapshot() const {
+        return Snapshot(loadRoot());
+    }
+
+    /**
+     * @brief Wstawia wartość, kopiując tylko ścieżkę od korzenia do nowego liścia.
+     * @param value Wartość do dodania.
+     * @return true, jeśli wartość została dodana; false, jeśli już istniała.
+     */
+    bool insert(const T& value) {
+        std::lock_guard<std::mutex> guard(writeLock);
+        bool inserted = false;
+        NodePtr next = insert(loadRoot(), value, inserted);
+        if (inserted) storeRoot(next);
+        return inserted;
+    }
+
+    /**
+     * @brief Usuwa wartość, kopiując tylko ścieżkę od korzenia do usuwanego węzła.
+     * @param value Wartość do usunięcia.
+     * @return true, jeśli wartość została usunięta; false, jeśli jej nie było.
+     */
+    bool remove(const T& value) {
+        std::lock_guard<std::mutex> guard(writeLock);
+        bool removed = false;
+        NodePtr next = remove(loadRoot(), value, removed);
+        if (removed) storeRoot(next);
+        return removed;
+    }
+
+    /**
+     * @brief Usuwa wszystkie elementy. Istniejące migawki pozostają nienaruszone.
+     */
+    void clear() {
+        std::lock_guard<std::mutex> guard(writeLock);
+        storeRoot(NodePtr());
+    }
+
+    bool search(const T& value) const { return snapshot().search(value); }
+    bool empty() const { return snapshot().empty(); }
+    std::size_t size() const { return snapshot().size(); }
+    bool isValid() const { return snapshot().isValid(); }
+
+private:
+    static int height(const NodePtr& node) {
+        return node ? node->height : 0;
+    }
+
+    static NodePtr makeNode(const T& value, const NodePtr& left, const NodePtr& right) {
+        return std::make_shared<const Node>(value, left, right);
+    }
+
+    /**
+     * @brief Tworzy nowy węzeł z wartością i dziećmi, wykonując w razie potrzeby rotację.
+     *
+     * Odpowiednik rebalance() z AVLTree - zamiast przepinać wskaźniki, tworzy
+     * nowe węzły dla zmienionej części poddrzewa.
+     */
+    static NodePtr balance(const T& value, const NodePtr& left, const NodePtr& right) {
+        int hl = height(left);
+        int hr = height(right);
+        if (hl > hr + 1) {
+            if (height(left->left) >= height(left->right)) {
+                return makeNode(left->value, left->left, makeNode(value, left->right, right));
+            }
+            return makeNode(left->right->value,
+                            makeNode(left->value, left->left, left->right->left),
+                            makeNode(value, left->right->right, right));
+        }
+        if (hr > hl + 1) {
+            if (height(right->right) >= height(right->left)) {
+                return makeNode(right->value, makeNode(value, left, right->left), right->right);
+            }
+            return makeNode(right->left->value,
+                            makeNode(value, left, right->left->left),
+                            makeNode(right->value, right->left->right, right->right));
+        }
+        return makeNode(value, left, right);
+    }
+
+    static NodePtr insert(const NodePtr& node, const T& value, bool& inserted) {
+        if (!node) {
+            inserted = true;
+            return makeNode(value, NodePtr(), NodePtr());
+        }
+        if (value < node->value) {
+            NodePtr left = insert(node->left, value, inserted);
+            return inserted ? balance(node->value, left, node->right) : node;
+        }
+        if (node->value < value) {
+            NodePtr right = insert(node->right, value, inserted);
+            return inserted ? balance(node->value, node->left, right) : node;
+        }
+        return node;
+    }
+
+    static NodePtr removeMin(const NodePtr& node) {
+        if (!node->left) return node->right;
+        return balance(node->value, removeMin(node->left), node->right);
+    }
+
+    static NodePtr remove(const NodePtr& node, const T& value, bool& removed) {
+        if (!node) return node;
+        if (value < node->value) {
+            NodePtr left = remove(node->left, value, removed);
+            return removed ? balance(node->value, left, node->right) : node;
+        }
+        if (node->value < value) {
+            NodePtr right = remove(node->right, value, removed);
+            return removed ? balance(node->value, node->left, right) : node;
+        }
+        removed = true;
+        if (!node->left) return node->right;
+        if (!node->right) return node->left;
+        const Node* successor = node->right.get();
+        while (successor->left) successor = successor->left.get();
+        return balance(successor->value, node->left, removeMin(node->right));
+    }
+
+#if defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr >= 201711L
+    NodePtr loadRoot() const { return root.load(std::memory_order_acquire); }
+    void storeRoot(const NodePtr& next) { root.store(next, std::memory_order_release); }
+
+    /**
+     * Korzeń bieżącej wersji (C++20: std::atomic<std::shared_ptr>).
+     */
+    std::atomic<NodePtr> root;
+#else
+    NodePtr loadRoot() const { return std::atomic_load(&root); }
+    void storeRoot(const NodePtr& next) { std::atomic_store(&root, next); }
+
+    /**
+     * Korzeń bieżącej wersji; odczytywany i publikowany przez std::atomic_load/atomic_store.
+     */
+    NodePtr root;
+#endif
+
+    /**
+     * Muteks serializujący piszących.
+     */
+    std::mutex writeLock;
+};
+
+#endif // PERSISTENTAVLTREE_H
@@ -0,0 +1,295 @@
+#include "AVLtree.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Nieinteraktywny zestaw benchmarków. Każde obciążenie wykonywane jest na AVLTree
+// i na std::set jako punkcie odniesienia. Każdy przypadek działa w osobnym procesie
+// potomnym, dzięki czemu szczytowe zużycie pamięci (peak RSS) dotyczy tylko jego.
+// Wyniki wypisywane są jako CSV (domyślnie) lub JSON (--json).
+//
+// Użycie: avl_bench [--ops N] [--json]
+
+// Opóźnienie mierzone jest dla co SampleEvery-tej operacji, żeby odczyt zegara
+// nie zaniżał przepustowości
+const std::size_t SampleEvery = 8;
+const std::size_t BatchSize = 256;
+
+enum OpType { Insert, Erase, Search };
+
+struct Op {
+    OpType type;
+    int key;
+};
+
+struct Workload {
+    std::string name;
+    std::vector<int> prefill;
+    std::vector<Op> ops;
+    bool batched;
+};
+
+struct Result {
+    char workload[32];
+    char structure[16];
+    std::size_t ops;
+    std::size_t hits;
+    double opsPerSecond;
+    double p50, p99, p999;
+    long peakRssKb;
+};
+
+// Adaptery sprowadzające oba drzewa do wspólnego interfejsu
+struct AVLSet {
+    static const char* name() { return "AVLTree"; }
+    AVLTree<int> tree;
+    bool insert(int key) { return tree.insert(key); }
+    bool erase(int key) { return tree.remove(key); }
+    bool search(int key) const { return tree.search(key); }
+    void searchBatch(const int* keys, std::size_t count, char* found) const {
+        tree.search_batch(keys, keys + count, found);
+    }
+};
+
+struct StdSet {
+    static const char* name() { return "std::set"; }
+    std::set<int> set;
+    bool insert(int key) { return set.insert(key).second; }
+    bool erase(int key) { return set.erase(key) == 1; }
+    bool search(int key) const { return set.count(key) == 1; }
+    void searchBatch(const int* keys, std::size_t count, char* found) const {
+        for (std::size_t i = 0; i < count; ++i) found[i] = set.count(keys[i]) == 1;
+    }
+};
+
+// Generator rozkładu Zipfa (s = 0.99) na rangach 0..n-1; rangi są mieszane,
+// aby najczęstsze klucze nie leżały obok siebie
+class Zipf {
+public:
+    Zipf(std::size_t n, double s) : cdf(n) {
+        double sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), s);
+            cdf[i] = sum;
+        }
+        for (std::size_t i = 0; i < n; ++i) cdf[i] /= sum;
+    }
+
+    int operator()(std::mt19937& rng) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        std::size_t rank = std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+        return static_cast<int>((rank * 2654435761u) & 0x7fffffff);
+    }
+
+private:
+    std::vector<double> cdf;
+};
+
+int randomKey(std::mt19937& rng) {
+    return static_cast<int>(rng() >> 1);
+}
+
+Workload makeWorkload(const std::string& name, std::size_t n) {
+    std::mt19937 rng(2024);
+    Workload w;
+    w.name = name;
+    w.batched = false;
+    w.ops.reserve(n);
+    if (name == "seq_insert") {
+        for (std::size_t i = 0; i < n; ++i) w.ops.push_back(Op{ Insert, static_cast<int>(i) });
+    } else if (name == "random_insert") {
+        for (std::size_t i = 0; i < n; ++i) w.ops.push_back(Op{ Insert, randomKey(rng) });
+    } else if (name == "zipf_insert") {
+        Zipf zipf(n, 0.99);
+        for (std::size_t i = 0; i < n; ++i) w.ops.push_back(Op{ Insert, zipf(rng) });
+    } else if (name == "search_hit" || name == "search_hit_batch" || name == "search_miss") {
+        // Drzewo zawiera klucze parzyste, więc klucze nieparzyste zawsze chybiają
+        for (std::size_t i = 0; i < n; ++i) w.prefill.push_back(randomKey(rng) & ~1);
+        for (std::size_t i = 0; i < n; ++i) {
+            int key = name == "search_miss" ? (randomKey(rng) | 1) : w.prefill[rng() % n];
+            w.ops.push_back(Op{ Search, key });
+        }
+        w.batched = name == "search_hit_batch";
+    } else if (name == "mixed") {
+        // 90% wyszukiwań, 5% wstawień i 5% usunięć na zakresie dwa razy większym niż drzewo
+        int range = static_cast<int>(2 * n);
+        for (std::size_t i = 0; i < n; ++i) w.prefill.push_back(static_cast<int>(rng() % range));
+        for (std::size_t i = 0; i < n; ++i) {
+            unsigned roll = rng() % 20;
+            OpType type = roll == 0 ? Insert : roll == 1 ? Erase : Search;
+            w.ops.push_back(Op{ type, static_cast<int>(rng() % range) });
+        }
+    } else if (name == "delete_heavy") {
+        // 80% usunięć kluczy z drzewa i 20% wstawień nowych
+        for (std::size_t i = 0; i < n; ++i) w.prefill.push_back(randomKey(rng));
+        for (std::size_t i = 0; i < n; ++i) {
+            bool erase = rng() % 5 != 0;
+            w.ops.push_back(Op{ erase ? Erase : Insert, erase ? w.prefill[rng() % n] : randomKey(rng) });
+        }
+    }
+    return w;
+}
+
+double percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) return 0;
+    std::size_t index = static_cast<std::size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+template <typename Set>
+Result execute(const Workload& w) {
+    typedef std::chrono::steady_clock Clock;
+    Set set;
+    for (std::size_t i = 0; i < w.prefill.size(); ++i) set.insert(w.prefill[i]);
+
+    std::vector<double> samples;
+    samples.reserve(w.ops.size() / SampleEvery + 1);
+    std::size_t hits = 0;
+    Clock::time_point begin = Clock::now();
+    if (w.batched) {
+        // Opóźnienie pojedynczego klucza to czas całej paczki podzielony przez jej rozmiar
+        std::vector<int> keys(BatchSize);
+        std::vector<char> found(BatchSize);
+        for (std::size_t i = 0; i < w.ops.size(); i += BatchSize) {
+            std::size_t count = std::min(BatchSize, w.ops.size() - i);
+            for (std::size_t j = 0; j < count; ++j) keys[j] = w.ops[i + j].key;
+            Clock::time_point start = Clock::now();
+            set.searchBatch(keys.data(), count, found.data());
+            std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+            samples.push_back(elapsed.count() / count);
+            for (std::size_t j = 0; j < count; ++j) hits += found[j];
+        }
+    } else {
+        for (std::size_t i = 0; i < w.ops.size(); ++i) {
+            const Op& op = w.ops[i];
+            bool sampled = i % SampleEvery == 0;
+            Clock::time_point start;
+            if (sampled) start = Clock::now();
+            bool hit = op.type == Insert ? set.insert(op.key) : op.type == Erase ? set.erase(op.key) : set.search(op.key);
+            if (sampled) {
+                std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+                samples.push_back(elapsed.count());
+            }
+            hits += hit;
+        }
+    }
+    std::chrono::duration<double> total = Clock::now() - begin;
+
+    Result result;
+    std::memset(&result, 0, sizeof(result));
+    std::strncpy(result.workload, w.name.c_str(), sizeof(result.workload) - 1);
+    std::strncpy(result.structure, Set::name(), sizeof(result.structure) - 1);
+    result.ops = w.ops.size();
+    result.hits = hits;
+    result.opsPerSecond = w.ops.size() / total.count();
+    result.p50 = percentile(samples, 0.5);
+    result.p99 = percentile(samples, 0.99);
+    result.p999 = percentile(samples, 0.999);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    result.peakRssKb = usage.ru_maxrss;
+    return result;
+}
+
+/**
+ * @brief Uruchamia przypadek w procesie potomnym i odbiera jego wynik przez potok.
+ * @return true, jeśli proces potomny zakończył się poprawnie.
+ */
+template <typename Set>
+bool runIsolated(const std::string& workload, std::size_t ops, Result& result) {
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        Result r = execute<Set>(makeWorkload(workload, ops));
+        ssize_t written = write(fds[1], &r, sizeof(r));
+        _exit(written == static_cast<ssize_t>(sizeof(r)) ? 0 : 1);
+    }
+    close(fds[1]);
+    ssize_t got = pid > 0 ? read(fds[0], &result, sizeof(result)) : -1;
+    close(fds[0]);
+    int status = 0;
+    if (pid > 0) waitpid(pid, &status, 0);
+    return got == static_cast<ssize_t>(sizeof(result)) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Liczba operacji musi być dodatnia (percentyle i ops/s dzielą przez nią), a klucze
+// obciążeń 2 * N muszą zmieścić się w int
+bool parseOps(const char* text, std::size_t& ops) {
+    char* end;
+    long long value = std::strtoll(text, &end, 10);
+    if (end == text || *end != '\0' || value < 1 || value > 1000000000) return false;
+    ops = static_cast<std::size_t>(value);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::size_t ops = 1000000;
+    bool json = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (std::strcmp(argv[i], "--ops") == 0 && i + 1 < argc && parseOps(argv[++i], ops)) {
+            continue;
+        } else {
+            std::cerr << "Użycie: " << argv[0] << " [--ops N] [--json]  (N - liczba operacji, 1..1000000000)" << std::endl;
+            return 2;
+        }
+    }
+
+    const char* workloads[] = { "seq_insert", "random_insert", "zipf_insert", "search_hit", "search_miss",
+                                "search_hit_batch", "mixed", "delete_heavy" };
+    std::vector<Result> results;
+    for (std::size_t i = 0; i < sizeof(workloads) / sizeof(workloads[0]); ++i) {
+        Result avl, baseline;
+        if (!runIsolated<AVLSet>(workloads[i], ops, avl) || !runIsolated<StdSet>(workloads[i], ops, baseline)) {
+            std::cerr << "Nie udało się wykonać obciążenia " << workloads[i] << std::endl;
+            return 1;
+        }
+        // Oba drzewa muszą dać te same wyniki operacji
+        if (avl.hits != baseline.hits) {
+            std::cerr << "Niezgodne wyniki AVLTree i std::set dla " << workloads[i] << std::endl;
+            return 1;
+        }
+        results.push_back(avl);
+        results.push_back(baseline);
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    if (json) {
+        std::cout << "[" << std::endl;
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::cout << "  {\"workload\": \"" << r.workload << "\", \"structure\": \"" << r.structure
+                      << "\", \"ops\": " << r.ops << ", \"hits\": " << r.hits
+                      << ", \"ops_per_s\": " << r.opsPerSecond << ", \"p50_ns\": " << r.p50
+                      << ", \"p99_ns\": " << r.p99 << ", \"p999_ns\": " << r.p999
+                      << ", \"peak_rss_kb\": " << r.peakRssKb << "}" << (i + 1 < results.size() ? "," : "")
+                      << std::endl;
+        }
+        std::cout << "]" << std::endl;
+    } else {
+        std::cout << "workload,structure,ops,hits,ops_per_s,p50_ns,p99_ns,p999_ns,peak_rss_kb" << std::endl;
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::cout << r.workload << "," << r.structure << "," << r.ops << "," << r.hits << ","
+                      << r.opsPerSecond << "," << r.p50 << "," << r.p99 << "," << r.p999 << ","
+                      << r.peakRssKb << std::endl;
+        }
+    }
+    return 0;
+}
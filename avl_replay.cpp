@@ -0,0 +1,321 @@
+#include "AVLtree.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Odtwarza zapisany dziennik operacji na AVLTree<long long> i mierzy przepustowość
+// oraz histogramy opóźnień poszczególnych rodzajów operacji.
+//
+// Format tekstowy - jedna operacja w wierszu:
+//   i KEY        wstawienie
+//   r KEY        usunięcie
+//   s KEY        wyszukiwanie
+//   q LO HI      przejście po elementach z przedziału [LO, HI]
+// Puste wiersze i wiersze zaczynające się od '#' są pomijane.
+// Format binarny - 8 bajtów "AVLOPLOG", a po nich rekordy BinaryOp (porządek bajtów maszyny).
+//
+// Dziennik czytany jest porcjami po ChunkSize bajtów. Domyślnie operacje wykonywane są
+// na bieżąco, więc całkowity czas obejmuje też odczyt i parsowanie; z --exclude-io cały
+// dziennik jest najpierw wczytywany do pamięci i mierzone jest tylko wykonanie operacji
+// (wygodne przy profilowaniu np. perf record).
+//
+// Użycie: avl_replay [--exclude-io] LOG
+//         avl_replay --generate N LOG [--binary]   (tworzy przykładowy dziennik)
+
+const std::size_t ChunkSize = 1 << 20;
+const char BinaryMagic[8] = { 'A', 'V', 'L', 'O', 'P', 'L', 'O', 'G' };
+
+// Liczba przedziałów histogramu; przedział b obejmuje opóźnienia [2^b, 2^(b+1)) ns
+const int Buckets = 32;
+
+enum OpType { Insert, Remove, Search, Range, OpTypes };
+const char* const OpNames[OpTypes] = { "insert", "remove", "search", "range" };
+const char OpCodes[OpTypes] = { 'i', 'r', 's', 'q' };
+
+struct Op {
+    OpType type;
+    long long key, high;
+};
+
+// Rekord dziennika binarnego
+struct BinaryOp {
+    std::uint64_t code; // znak operacji: 'i', 'r', 's' lub 'q'
+    std::int64_t key;
+    std::int64_t high;  // górna granica dla 'q', w pozostałych operacjach nieużywana
+};
+
+// Czyta dziennik porcjami; niedokończony wiersz lub rekord z końca porcji
+// przenoszony jest na początek następnej
+class LogReader {
+public:
+    explicit LogReader(std::FILE* file) : file(file), buffer(ChunkSize), begin(0), end(0), eof(false), binary(false), line(0) {
+        fill();
+        if (end >= sizeof(BinaryMagic) && std::memcmp(buffer.data(), BinaryMagic, sizeof(BinaryMagic)) == 0) {
+            binary = true;
+            begin = sizeof(BinaryMagic);
+        }
+    }
+
+    /**
+     * @brief Odczytuje kolejną operację.
+     * @return false na końcu dziennika.
+     * @throws std::runtime_error Jeśli wiersz lub rekord jest niepoprawny.
+     */
+    bool next(Op& op) {
+        return binary ? nextBinary(op) : nextText(op);
+    }
+
+private:
+    void fill() {
+        // Niewykorzystana końcówka trafia na początek bufora
+        std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+        if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+        std::size_t got = std::fread(buffer.data() + end, 1, buffer.size() - end, file);
+        end += got;
+        if (got == 0) eof = true;
+    }
+
+    bool nextBinary(Op& op) {
+        while (end - begin < sizeof(BinaryOp)) {
+            if (eof) {
+                if (begin != end) throw std::runtime_error("Niepełny rekord na końcu dziennika.");
+                return false;
+            }
+            fill();
+        }
+        BinaryOp record;
+        std::memcpy(&record, buffer.data() + begin, sizeof(record));
+        begin += sizeof(record);
+        ++line;
+        op.type = decode(static_cast<char>(record.code));
+        op.key = record.key;
+        op.high = record.high;
+        return true;
+    }
+
+    bool nextText(Op& op) {
+        for (;;) {
+            char* start = buffer.data() + begin;
+            char* newline = static_cast<char*>(std::memchr(start, '\n', end - begin));
+            if (!newline) {
+                if (!eof) {
+                    fill();
+                    continue;
+                }
+                if (begin == end) return false;
+                // Ostatni wiersz bez znaku nowej linii
+                if (end == buffer.size()) buffer.push_back('\0');
+                newline = buffer.data() + end;
+                start = buffer.data() + begin;
+                end = begin = newline - buffer.data();
+            } else {
+                begin = newline + 1 - buffer.data();
+            }
+            *newline = '\0';
+            ++line;
+            while (*start == ' ' || *start == '\t' || *start == '\r') ++start;
+            if (*start == '\0' || *start == '#') continue;
+            op.type = decode(*start);
+            char* cursor = start + 1;
+            char* after;
+            op.key = std::strtoll(cursor, &after, 10);
+            if (after == cursor) throw std::runtime_error("Brak klucza w wierszu " + std::to_string(line) + ".");
+            op.high = op.key;
+            if (op.type == Range) {
+                cursor = after;
+                op.high = std::strtoll(cursor, &after, 10);
+                if (after == cursor) throw std::runtime_error("Brak górnej granicy w wierszu " + std::to_string(line) + ".");
+            }
+            return true;
+        }
+    }
+
+    OpType decode(char code) const {
+        for (int t = 0; t < OpTypes; ++t) {
+            if (OpCodes[t] == code) return static_cast<OpType>(t);
+        }
+        throw std::runtime_error(std::string("Nieznana operacja '") + code + "' (wiersz/rekord " +
+                                 std::to_string(line) + ").");
+    }
+
+    std::FILE* file;
+    std::vector<char> buffer;
+    std::size_t begin, end;
+    bool eof, binary;
+    std::size_t line;
+};
+
+struct Histogram {
+    std::uint64_t counts[Buckets];
+    std::uint64_t total;
+    double sumNs;
+
+    Histogram() : total(0), sumNs(0) { std::memset(counts, 0, sizeof(counts)); }
+
+    void add(double ns) {
+        std::uint64_t value = ns < 1 ? 1 : static_cast<std::uint64_t>(ns);
+        int bucket = 63 - __builtin_clzll(value);
+        ++counts[bucket < Buckets ? bucket : Buckets - 1];
+        ++total;
+        sumNs += ns;
+    }
+
+    // Górna granica przedziału zawierającego percentyl p (przybliżenie z dokładnością do 2x)
+    double percentile(double p) const {
+        std::uint64_t target = static_cast<std::uint64_t>(p * total);
+        std::uint64_t seen = 0;
+        for (int b = 0; b < Buckets; ++b) {
+            seen += counts[b];
+            if (seen > target) return static_cast<double>(2ull << b);
+        }
+        return static_cast<double>(2ull << (Buckets - 1));
+    }
+};
+
+class Replayer {
+public:
+    Replayer() : checksum(0) {}
+
+    void apply(const Op& op) {
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point start = Clock::now();
+        switch (op.type) {
+        case Insert:
+            tree.insert(op.key);
+            break;
+        case Remove:
+            checksum += tree.remove(op.key);
+            break;
+        case Search:
+            checksum += tree.search(op.key);
+            break;
+        default:
+            for (AVLTree<long long>::iterator it = tree.lower_bound(op.key); it != tree.end() && *it <= op.high; ++it) {
+                checksum += static_cast<std::uint64_t>(*it);
+            }
+            break;
+        }
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        histograms[op.type].add(elapsed.count());
+    }
+
+    void report(double seconds, bool excludeIo) const {
+        std::uint64_t ops = 0;
+        for (int t = 0; t < OpTypes; ++t) ops += histograms[t].total;
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "# operacje: " << ops << ", czas: " << seconds << " s ("
+                  << (excludeIo ? "bez odczytu dziennika" : "z odczytem dziennika") << "), przepustowość: "
+                  << ops / seconds << " ops/s, rozmiar drzewa: " << tree.size()
+                  << ", suma kontrolna: " << checksum << std::endl;
+        std::cout << "op,count,mean_ns,p50_ns,p99_ns,p999_ns" << std::endl;
+        for (int t = 0; t < OpTypes; ++t) {
+            const Histogram& h = histograms[t];
+            if (!h.total) continue;
+            std::cout << OpNames[t] << "," << h.total << "," << h.sumNs / h.total << "," << h.percentile(0.5)
+                      << "," << h.percentile(0.99) << "," << h.percentile(0.999) << std::endl;
+        }
+        std::cout << "op,bucket_lo_ns,bucket_hi_ns,count" << std::endl;
+        for (int t = 0; t < OpTypes; ++t) {
+            for (int b = 0; b < Buckets; ++b) {
+                if (!histograms[t].counts[b]) continue;
+                std::cout << OpNames[t] << "," << (1ull << b) << "," << (2ull << b) << ","
+                          << histograms[t].counts[b] << std::endl;
+            }
+        }
+    }
+
+private:
+    AVLTree<long long> tree;
+    Histogram histograms[OpTypes];
+    std::uint64_t checksum;
+};
+
+/**
+ * @brief Zapisuje przykładowy dziennik: 50% wyszukiwań, 30% wstawień, 15% usunięć i 5% przedziałów.
+ */
+int generate(std::size_t count, const char* path, bool binary) {
+    std::FILE* file = std::fopen(path, binary ? "wb" : "w");
+    if (!file) {
+        std::cerr << "Nie można utworzyć pliku " << path << std::endl;
+        return 1;
+    }
+    std::mt19937_64 rng(2024);
+    long long range = static_cast<long long>(count) + 1;
+    if (binary) std::fwrite(BinaryMagic, 1, sizeof(BinaryMagic), file);
+    for (std::size_t i = 0; i < count; ++i) {
+        unsigned roll = rng() % 20;
+        OpType type = roll < 10 ? Search : roll < 16 ? Insert : roll < 19 ? Remove : Range;
+        long long key = static_cast<long long>(rng() % range);
+        long long high = type == Range ? key + 16 : key;
+        if (binary) {
+            BinaryOp record = { static_cast<std::uint64_t>(OpCodes[type]), key, high };
+            std::fwrite(&record, sizeof(record), 1, file);
+        } else if (type == Range) {
+            std::fprintf(file, "q %lld %lld\n", key, high);
+        } else {
+            std::fprintf(file, "%c %lld\n", OpCodes[type], key);
+        }
+    }
+    return std::fclose(file) == 0 ? 0 : 1;
+}
+
+int usage(const char* program) {
+    std::cerr << "Użycie: " << program << " [--exclude-io] LOG" << std::endl
+              << "       " << program << " --generate N LOG [--binary]   (N - liczba operacji, N >= 1)" << std::endl;
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--generate") == 0) {
+        // N musi być dodatnią liczbą całkowitą, a jedyną dodatkową opcją jest --binary
+        bool binary = argc == 5 && std::strcmp(argv[4], "--binary") == 0;
+        if (argc != 4 + binary) return usage(argv[0]);
+        char* end;
+        long long count = std::strtoll(argv[2], &end, 10);
+        if (end == argv[2] || *end != '\0' || count < 1) return usage(argv[0]);
+        return generate(static_cast<std::size_t>(count), argv[3], binary);
+    }
+    bool excludeIo = argc == 3 && std::strcmp(argv[1], "--exclude-io") == 0;
+    if (argc != 2 + excludeIo) return usage(argv[0]);
+    const char* path = argv[argc - 1];
+    std::FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        std::cerr << "Nie można otworzyć pliku " << path << std::endl;
+        return 1;
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    Replayer replayer;
+    double seconds = 0;
+    try {
+        LogReader reader(file);
+        Op op;
+        if (excludeIo) {
+            std::vector<Op> ops;
+            while (reader.next(op)) ops.push_back(op);
+            Clock::time_point start = Clock::now();
+            for (std::size_t i = 0; i < ops.size(); ++i) replayer.apply(ops[i]);
+            seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        } else {
+            Clock::time_point start = Clock::now();
+            while (reader.next(op)) replayer.apply(op);
+            seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+    } catch (const std::runtime_error& e) {
+        std::fclose(file);
+        std::cerr << path << ": " << e.what() << std::endl;
+        return 1;
+    }
+    std::fclose(file);
+    replayer.report(seconds, excludeIo);
+    return 0;
+}
@@ -0,0 +1,109 @@
+// avl_stats_test.cpp
+// Testy liczników operacji. Program kompilowany jest z AVLTREE_STATS, dzięki
+// czemu main.cpp sprawdza domyślną konfigurację drzewa bez liczników.
+#define AVLTREE_STATS
+#include "AVLtree.h"
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+void test1(bool debug) {
+    std::cout << "\033[33m====================  TEST 1 ====================\033[0m" << std::endl;
+    // Kolejne wartości 1..7 wymuszają cztery pojedyncze rotacje i dają drzewo doskonałe
+    AVLTree<int> tree;
+    for (int i = 1; i <= 7; ++i) tree.insert(i);
+    AVLStats stats = tree.stats();
+    assert(stats.enabled);
+    assert(stats.singleRotations == 4 && stats.doubleRotations == 0);
+    assert(stats.allocations == 7 && stats.frees == 0 && stats.updates == 7);
+    assert(stats.rebalanceSteps >= 7);
+    assert(stats.depthHistogram == std::vector<std::size_t>({ 1, 2, 4 }));
+
+    tree.reset_stats();
+    assert(tree.search(4) && tree.search(7) && !tree.search(8));
+    stats = tree.stats();
+    assert(stats.searches == 3 && stats.comparisons == 1 + 3 + 3);
+    assert(stats.comparisonsPerSearch() > 2.3 && stats.comparisonsPerSearch() < 2.4);
+    assert(tree.remove(1));
+    stats = tree.stats();
+    assert(stats.updates == 1 && stats.frees == 1);
+
+    // Lewy-prawy przypadek wymaga podwójnej rotacji
+    AVLTree<int> zigzag;
+    zigzag.insert(3);
+    zigzag.insert(1);
+    zigzag.insert(2);
+    assert(zigzag.stats().doubleRotations == 1 && zigzag.stats().singleRotations == 0);
+
+    // Zwolnienie puli w O(1) także jest liczone
+    zigzag.clear();
+    assert(zigzag.stats().frees == 3 && zigzag.stats().depthHistogram.empty());
+
+    std::string json = tree.stats().to_json();
+    assert(json.find("\"double_rotations\": 0") != std::string::npos);
+    assert(json.find("\"depth_histogram\": [1, 2, 3]") != std::string::npos);
+    if (debug) std::cout << json << std::endl;
+
+    // Wyszukiwanie wsadowe liczy zejścia i porównania tak samo jak search
+    tree.reset_stats();
+    int batch[] = { 4, 7, 8 };
+    bool found[3];
+    tree.search_batch(batch, batch + 3, found);
+    stats = tree.stats();
+    assert(found[0] && found[1] && !found[2]);
+    assert(stats.searches == 3 && stats.comparisons == 1 + 3 + 3);
+
+    // Węzły budowane równolegle w pamięci przydzielonej z góry też są liczone
+    std::vector<int> sorted(100000);
+    std::iota(sorted.begin(), sorted.end(), 0);
+    AVLTree<int> built = AVLTree<int>::parallel_build_from_sorted(sorted.begin(), sorted.end());
+    built.clear();
+    assert(built.stats().allocations == 100000 && built.stats().frees == 100000);
+
+    // Przypisanie przenoszące, tak jak konstruktor, zabiera liczniki źródła
+    AVLTree<int> source, target;
+    for (int i = 0; i < 10; ++i) source.insert(i);
+    target.insert(100);
+    target = std::move(source);
+    assert(target.stats().allocations == 10 && source.stats().allocations == 0);
+}
+
+void test2(bool debug) {
+    std::cout << "\033[33m====================  TEST 2 ====================\033[0m" << std::endl;
+    (void)debug;
+    // Dopisywanie rosnących kluczy z podpowiedzią end() - stała liczba porównań na wstawienie
+    const int count = 100000;
+    AVLTree<int> appended;
+    for (int i = 0; i < count; ++i) appended.insert(appended.end(), i);
+    AVLStats stats = appended.stats();
+    assert(stats.searches == static_cast<std::uint64_t>(count) && stats.comparisonsPerSearch() <= 2.0);
+
+    // To samo malejąco z podpowiedzią begin()
+    AVLTree<int> prepended;
+    for (int i = count; i > 0; --i) prepended.insert(prepended.begin(), i);
+    assert(prepended.stats().comparisonsPerSearch() <= 2.0);
+
+    // Prawie uporządkowane znaczniki czasu: podpowiedzią jest poprzednio wstawiony element
+    AVLTree<long long> timestamps;
+    std::srand(29);
+    AVLTree<long long>::iterator finger = timestamps.end();
+    for (long long t = 0; t < count; ++t) {
+        finger = timestamps.insert(finger, t * 4 - std::rand() % 32);
+    }
+    assert(timestamps.stats().comparisonsPerSearch() < 4.0);
+}
+
+// Wywołanie z opcją -v wypisuje migawki statystyk w formacie JSON
+int main(int argc, char* argv[]) {
+    bool debug = argc > 1 && std::strcmp(argv[1], "-v") == 0;
+    test1(debug);
+    test2(debug);
+
+    std::cout << "\033[32mWszystkie testy liczników zostały zaliczone!\033[0m" << std::endl;
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "AVLtree.h"
+#include "ConcurrentAVLtree.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Test obciążeniowy: wiele wątków wykonuje naraz wstawienia, usunięcia i wyszukiwania,
+// a program mierzy przepustowość dla 1..N wątków. Wynik ConcurrentAVLTree porównywany
+// jest z AVLTree chronionym jednym globalnym muteksem.
+// Użycie: avl_stress [N] - N to największa liczba wątków (domyślnie liczba rdzeni).
+
+// AVLTree za jednym muteksem - punkt odniesienia
+class LockedAVLTree {
+public:
+    bool insert(int value) {
+        std::lock_guard<std::mutex> guard(lock);
+        return tree.insert(value);
+    }
+    bool remove(int value) {
+        std::lock_guard<std::mutex> guard(lock);
+        return tree.remove(value);
+    }
+    bool search(int value) {
+        std::lock_guard<std::mutex> guard(lock);
+        return tree.search(value);
+    }
+    std::size_t size() {
+        std::lock_guard<std::mutex> guard(lock);
+        return tree.size();
+    }
+
+private:
+    std::mutex lock;
+    AVLTree<int> tree;
+};
+
+// Każdy wątek wykonuje ops operacji: 50% wyszukiwań, 25% wstawień, 25% usunięć
+template <typename Tree>
+double run(Tree& tree, unsigned threads, int ops, int keyRange) {
+    std::atomic<bool> start(false);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&tree, &start, t, ops, keyRange] {
+            std::mt19937 rng(1234 + t);
+            while (!start.load()) std::this_thread::yield();
+            for (int i = 0; i < ops; ++i) {
+                int key = static_cast<int>(rng() % keyRange);
+                unsigned op = rng() % 4;
+                if (op == 0) {
+                    tree.insert(key);
+                } else if (op == 1) {
+                    tree.remove(key);
+                } else {
+                    tree.search(key);
+                }
+            }
+        }));
+    }
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    start.store(true);
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return threads * static_cast<double>(ops) / elapsed.count();
+}
+
+int main(int argc, char** argv) {
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1) {
+        // Liczba wątków musi być dodatnią liczbą całkowitą - inaczej runda z zerem wątków dałaby NaN
+        char* end;
+        long threads = std::strtol(argv[1], &end, 10);
+        if (argc > 2 || end == argv[1] || *end != '\0' || threads < 1 || threads > 4096) {
+            std::cerr << "Użycie: " << argv[0] << " [N]  (N - największa liczba wątków, 1..4096)" << std::endl;
+            return 2;
+        }
+        maxThreads = static_cast<unsigned>(threads);
+    }
+    const int ops = 200000;
+    const int keyRange = 1 << 20;
+
+    // Liczby wątków: kolejne potęgi dwójki oraz maxThreads
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(maxThreads);
+
+    std::cout << "threads,concurrent_ops_per_s,locked_ops_per_s,speedup" << std::endl;
+    for (std::size_t k = 0; k < counts.size(); ++k) {
+        unsigned threads = counts[k];
+        ConcurrentAVLTree<int> concurrent(256);
+        LockedAVLTree locked;
+        for (int i = 0; i < keyRange; i += 2) {
+            concurrent.insert(i);
+            locked.insert(i);
+        }
+        double c = run(concurrent, threads, ops, keyRange);
+        double l = run(locked, threads, ops, keyRange);
+        assert(concurrent.isValid());
+        std::cout << threads << "," << std::fixed << std::setprecision(0) << c << "," << l << ","
+                  << std::setprecision(2) << c / l << std::endl;
+    }
+    return 0;
+}
@@ -1,42 +1,67 @@
 #include "AVLtree.h"
+#include "PersistentAVLtree.h"
+#include "ConcurrentAVLtree.h"
+#include "AVLmap.h"
+#include "AVLmultiset.h"
+#include "CompactAVLtree.h"
 #include <cassert>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <cstdlib>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <set>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
 
+// Drzewo z obserwatorem wypisującym przebieg operacji - wizualizacja w testach 1-7
+typedef AVLTree<int, std::less<int>, PoolAllocator, TracingObserver> TracedTree;
+
+// Obserwator wypisuje zmiany tylko wtedy, gdy użytkownik wybrał wizualizację
+TracingObserver tracer(bool debug) {
+    return TracingObserver(debug ? &std::cout : nullptr);
+}
 
 void test1(bool debug) {
     std::cout << "\033[33m====================  TEST 1 ====================\033[0m" << std::endl;
-    AVLTree<int> tree;
+    TracedTree tree(tracer(debug));
 
     // Test wstawiania i balansowania (wszystkie przypadki rotacji)
-    tree.insert(30, debug);
-    tree.insert(20, debug);
-    tree.insert(10, debug); // Test LL
+    tree.insert(30);
+    tree.insert(20);
+    tree.insert(10); // Test LL
     assert(tree.search(30) && tree.search(20) && tree.search(10));
     assert(tree.isValid());
 
-    tree.insert(40, debug);
-    tree.insert(50, debug); // Test RR
+    tree.insert(40);
+    tree.insert(50); // Test RR
     assert(tree.search(40) && tree.search(50));
     assert(tree.isValid());
 
-    tree.insert(35, debug); // Test RL
+    tree.insert(35); // Test RL
     assert(tree.search(35));
     assert(tree.isValid());
 
-    tree.insert(25, debug); // Test LR
+    tree.insert(25); // Test LR
     assert(tree.search(25));
     assert(tree.isValid());
 
     // Test usuwania i balansowania
-    tree.remove(50, debug);
+    tree.remove(50);
     assert(!tree.search(50));
     assert(tree.isValid());
 
-    tree.remove(30, debug);
+    tree.remove(30);
     assert(!tree.search(30));
     assert(tree.isValid());
 
-    tree.remove(10, debug);
+    tree.remove(10);
     assert(!tree.search(10));
     assert(tree.isValid());
 
@@ -45,37 +70,37 @@ void test1(bool debug) {
     assert(tree.find_max() == 40);
 
     // Test konstrukcji kopiującej
-    AVLTree<int> copiedTree = tree;
+    TracedTree copiedTree = tree;
     assert(copiedTree.search(20) && copiedTree.search(40) && copiedTree.search(25));
     assert(copiedTree.isValid());
 
     // Test operatora przypisania
-    AVLTree<int> assignedTree;
+    TracedTree assignedTree(tracer(debug));
     assignedTree = tree;
     assert(assignedTree.search(20) && assignedTree.search(40) && assignedTree.search(25));
     assert(assignedTree.isValid());
 
     // Test wstawiania do skopiowanego drzewa
-    copiedTree.insert(60, debug);
+    copiedTree.insert(60);
     assert(copiedTree.search(60) && !tree.search(60));
     assert(copiedTree.isValid());
 
     // Test usuwania w skopiowanym drzewie
-    copiedTree.remove(20, debug);
+    copiedTree.remove(20);
     assert(!copiedTree.search(20) && tree.search(20));
     assert(copiedTree.isValid());
 
     // Test w dużym drzewie
     AVLTree<int> largeTree;
     for (int i = 1; i <= 100; ++i) {
-        largeTree.insert(i, debug);
+        largeTree.insert(i);
     }
     assert(largeTree.isValid());
     for (int i = 1; i <= 100; ++i) {
         assert(largeTree.search(i));
     }
     for (int i = 1; i <= 100; i += 2) {
-        largeTree.remove(i, debug);
+        largeTree.remove(i);
     }
     assert(largeTree.isValid());
     for (int i = 1; i <= 100; ++i) {
@@ -88,7 +113,7 @@ void test1(bool debug) {
 
     // Test balansowania w dużym drzewie
     for (int i = 101; i <= 200; ++i) {
-        largeTree.insert(i, debug);
+        largeTree.insert(i);
     }
     assert(largeTree.find_min() == 2);
     assert(largeTree.find_max() == 200);
@@ -98,36 +123,36 @@ void test1(bool debug) {
 
 void test2(bool debug) {
     std::cout << "\033[33m====================  TEST 2 ====================\033[0m" << std::endl;
-    AVLTree<int> tree;
+    TracedTree tree(tracer(debug));
 
     // Test LL
-    tree.insert(30, debug);
-    tree.insert(20, debug);
-    tree.insert(10, debug);
+    tree.insert(30);
+    tree.insert(20);
+    tree.insert(10);
     assert(tree.isValid());
 
     // Test RR
-    tree.insert(40, debug);
-    tree.insert(50, debug);
+    tree.insert(40);
+    tree.insert(50);
     assert(tree.isValid());
 
     // Test LR
-    tree.insert(25, debug);
+    tree.insert(25);
     assert(tree.isValid());
 
     // Test RL
-    tree.insert(45, debug);
-    tree.insert(35, debug);
+    tree.insert(45);
+    tree.insert(35);
     assert(tree.isValid());
 }
 
 void test3(bool debug) {
     std::cout << "\033[33m====================  TEST 3 ====================\033[0m" << std::endl;
-    AVLTree<int> tree;
+    TracedTree tree(tracer(debug));
 
-    tree.insert(10, debug);
-    tree.insert(20, debug);
-    tree.insert(5, debug);
+    tree.insert(10);
+    tree.insert(20);
+    tree.insert(5);
 
     assert(tree.find_min() == 5);
     assert(tree.find_max() == 20);
@@ -135,9 +160,9 @@ void test3(bool debug) {
 
 void test4(bool debug) {
     std::cout << "\033[33m====================  TEST 4 ====================\033[0m" << std::endl;
-    AVLTree<int> tree;
+    TracedTree tree(tracer(debug));
     for (int i = 1; i <= 15; ++i) {
-        tree.insert(i, debug);
+        tree.insert(i);
     }
 
     assert(tree.countNodes() == 15);
@@ -146,9 +171,9 @@ void test4(bool debug) {
     tree.clear();
     assert(tree.empty());
 
-    tree.insert(10, debug);
-    tree.insert(20, debug);
-    tree.insert(5, debug);
+    tree.insert(10);
+    tree.insert(20);
+    tree.insert(5);
 
     int balance = tree.getBalanceFactor(10);
     assert(balance == 0);
@@ -157,7 +182,7 @@ void test4(bool debug) {
 void test5(bool debug) {
     std::cout << "\033[33m====================  TEST 5 ====================\033[0m" << std::endl;
     //Edge Cases
-    AVLTree<int> tree;
+    TracedTree tree(tracer(debug));
 
     // Test na pustym drzewie
     try {
@@ -174,34 +199,31 @@ void test5(bool debug) {
         // Oczekiwany wyjątek
     }
 
-    try {
-        tree.remove(10, debug);
-        assert(false); // Powinno rzucić wyjątek
-    } catch (const std::runtime_error&) {
-        // Oczekiwany wyjątek
-    }
+    // Usuwanie z pustego drzewa nie jest błędem
+    assert(!tree.remove(10));
 
-    tree.insert(15, debug);
+    tree.insert(15);
     assert(tree.find_min() == 15);
     assert(tree.find_max() == 15);
-    tree.remove(15, debug);
-    assert(tree.isValid());
+    assert(!tree.remove(10));
+    assert(tree.remove(15));
+    assert(tree.isValid() && tree.empty());
 }
 
 void test6(bool debug) {
     std::cout << "\033[33m====================  TEST 6 ====================\033[0m" << std::endl;
-    AVLTree<int> tree1;
-    tree1.insert(10, debug);
-    tree1.insert(20, debug);
-    tree1.insert(5, debug);
+    TracedTree tree1(tracer(debug));
+    tree1.insert(10);
+    tree1.insert(20);
+    tree1.insert(5);
 
     // Test copy constructor
-    AVLTree<int> tree2(tree1);
+    TracedTree tree2(tree1);
     assert(tree2.find_min() == 5);
     assert(tree2.find_max() == 20);
 
     // Test = operator
-    AVLTree<int> tree3;
+    TracedTree tree3(tracer(debug));
     tree3 = tree1;
     assert(tree3.find_min() == 5);
     assert(tree3.find_max() == 20);
@@ -209,37 +231,1344 @@ void test6(bool debug) {
 
 void test7(bool debug) {
     std::cout << "\033[33m====================  TEST 7 ====================\033[0m" << std::endl;
-    AVLTree<int> tree;
+    TracedTree tree(tracer(debug));
 
-    tree.insert(20, debug);
-    tree.insert(10, debug);
-    tree.insert(30, debug);
-    tree.insert(25, debug);
-    tree.insert(35, debug);
+    tree.insert(20);
+    tree.insert(10);
+    tree.insert(30);
+    tree.insert(25);
+    tree.insert(35);
 
     // remove zwykły
-    tree.remove(10, debug);
+    tree.remove(10);
     assert(tree.isValid());
 
     // Test LL remove
-    tree.remove(35, debug);
+    tree.remove(35);
     assert(tree.isValid());
 
     // Test RR remove
-    tree.remove(25, debug);
+    tree.remove(25);
     assert(tree.isValid());
 
     // Test RL remove
-    tree.insert(40, debug);
-    tree.insert(45, debug);
-    tree.remove(20, debug);
+    tree.insert(40);
+    tree.insert(45);
+    tree.remove(20);
     assert(tree.isValid());
 
     // Test LR remove
-    tree.insert(15, debug);
-    tree.insert(17, debug);
-    tree.remove(30, debug);
+    tree.insert(15);
+    tree.insert(17);
+    tree.remove(30);
+    assert(tree.isValid());
+}
+
+void test8(bool debug) {
+    std::cout << "\033[33m====================  TEST 8 ====================\033[0m" << std::endl;
+    (void)debug;
+    // Dwa drzewa korzystające ze wspólnej puli węzłów
+    PoolAllocator pool;
+    AVLTree<int> tree1(pool);
+    AVLTree<int> tree2(pool);
+    for (int i = 1; i <= 1000; ++i) {
+        tree1.insert(i);
+        tree2.insert(-i);
+    }
+    for (int i = 1; i <= 1000; i += 2) {
+        tree1.remove(i);
+    }
+    // Zwolnione węzły są ponownie wykorzystywane przez drugie drzewo
+    for (int i = 1001; i <= 1500; ++i) {
+        tree2.insert(-i);
+    }
+    assert(tree1.isValid() && tree2.isValid());
+    assert(tree1.countNodes() == 500 && tree2.countNodes() == 1500);
+    tree1.clear();
+    assert(tree1.empty() && tree2.search(-1500));
+
+    // Drzewo z areną: clear() zwalnia wszystko naraz, a pamięć wraca do użytku
+    AVLTree<int, std::less<int>, ArenaAllocator> arenaTree;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 1; i <= 200; ++i) {
+            arenaTree.insert(i);
+        }
+        assert(arenaTree.countNodes() == 200 && arenaTree.isValid());
+        arenaTree.clear();
+        assert(arenaTree.empty());
+    }
+
+    // Typ z nietrywialnym destruktorem jest niszczony węzeł po węźle
+    AVLTree<std::string, std::less<std::string>, HeapAllocator> strings;
+    strings.insert("avl");
+    strings.insert("drzewo");
+    strings.insert("węzeł");
+    AVLTree<std::string, std::less<std::string>, HeapAllocator> stringsCopy(strings);
+    strings.clear();
+    assert(strings.empty() && stringsCopy.search("drzewo"));
+}
+
+void test9(bool debug) {
+    std::cout << "\033[33m====================  TEST 9 ====================\033[0m" << std::endl;
+    (void)debug;
+    // Losowe wstawienia i usunięcia - isValid() sprawdza też wskaźniki up i wysokości
+    AVLTree<int> tree;
+    std::srand(12345);
+    int present[512] = {0};
+    for (int step = 0; step < 20000; ++step) {
+        int key = std::rand() % 512;
+        if (std::rand() % 2) {
+            tree.insert(key);
+            present[key] = 1;
+        } else if (present[key]) {
+            tree.remove(key);
+            present[key] = 0;
+        }
+        if (step % 500 == 0) assert(tree.isValid());
+    }
+    assert(tree.isValid());
+    int expected = 0;
+    for (int key = 0; key < 512; ++key) {
+        expected += present[key];
+        assert(tree.search(key) == (present[key] == 1));
+    }
+    assert(tree.countNodes() == expected);
+
+    // Usuwanie korzenia aż do opróżnienia drzewa
+    while (!tree.empty()) {
+        tree.remove(tree.top());
+        assert(tree.isValid());
+    }
+}
+
+void test10(bool debug) {
+    std::cout << "\033[33m====================  TEST 10 ====================\033[0m" << std::endl;
+    (void)debug;
+    AVLTree<int> tree;
+    for (int i = 1; i <= 50; ++i) {
+        tree.insert(i * 2);
+    }
+
+    // Przejście w przód i w tył w kolejności rosnącej
+    assert(std::is_sorted(tree.begin(), tree.end()));
+    assert(std::distance(tree.begin(), tree.end()) == 50);
+    assert(*tree.begin() == 2 && *tree.rbegin() == 100);
+    assert(*--tree.end() == 100);
+    std::vector<int> backwards(tree.rbegin(), tree.rend());
+    assert(backwards.size() == 50 && backwards.front() == 100 && backwards.back() == 2);
+    assert(std::accumulate(tree.begin(), tree.end(), 0) == 2550);
+
+    // Wyszukiwanie zakresów
+    assert(*tree.lower_bound(31) == 32 && *tree.lower_bound(32) == 32);
+    assert(*tree.upper_bound(32) == 34);
+    assert(tree.lower_bound(101) == tree.end() && tree.upper_bound(100) == tree.end());
+    assert(std::distance(tree.lower_bound(10), tree.upper_bound(20)) == 6);
+    std::pair<AVLTree<int>::iterator, AVLTree<int>::iterator> range = tree.equal_range(40);
+    assert(std::distance(range.first, range.second) == 1 && *range.first == 40);
+    range = tree.equal_range(41);
+    assert(range.first == range.second);
+    assert(tree.find(64) != tree.end() && tree.find(65) == tree.end());
+    assert(std::find(tree.begin(), tree.end(), 64) == tree.find(64));
+
+    // Iteratory pozostają poprawne po wstawieniach innych elementów
+    AVLTree<int>::iterator it = tree.find(50);
+    for (int i = 0; i < 50; ++i) {
+        tree.insert(i * 2 + 1);
+    }
+    assert(*it == 50 && *++it == 51);
+
+    AVLTree<int> empty;
+    assert(empty.begin() == empty.end() && empty.rbegin() == empty.rend());
+}
+
+void test11(bool debug) {
+    std::cout << "\033[33m====================  TEST 11 ====================\033[0m" << std::endl;
+    (void)debug;
+    AVLTree<int> tree;
+    std::vector<int> reference;
+    std::srand(777);
+    for (int step = 0; step < 5000; ++step) {
+        int key = std::rand() % 1000;
+        std::vector<int>::iterator pos = std::lower_bound(reference.begin(), reference.end(), key);
+        bool present = pos != reference.end() && *pos == key;
+        if (std::rand() % 3) {
+            tree.insert(key);
+            if (!present) reference.insert(pos, key);
+        } else if (present) {
+            tree.remove(key);
+            reference.erase(pos);
+        }
+    }
+    assert(tree.isValid());
+    assert(tree.size() == reference.size());
+
+    // rank i select zgadzają się z posortowanym wektorem
+    for (std::size_t k = 0; k < reference.size(); ++k) {
+        assert(tree.select(k) == reference[k]);
+        assert(tree.rank(reference[k]) == k);
+    }
+    for (int key = -1; key <= 1000; key += 7) {
+        std::size_t expected = std::lower_bound(reference.begin(), reference.end(), key) - reference.begin();
+        assert(tree.rank(key) == expected);
+    }
+
+    // Mediana i percentyle
+    AVLTree<int> values;
+    for (int i = 1; i <= 101; ++i) {
+        values.insert(i);
+    }
+    assert(values.select(values.size() / 2) == 51);
+    assert(values.select(values.size() * 99 / 100) == 100);
+    try {
+        values.select(values.size());
+        assert(false); // Powinno rzucić wyjątek
+    } catch (const std::out_of_range&) {
+        // Oczekiwany wyjątek
+    }
+}
+
+void test12(bool debug) {
+    std::cout << "\033[33m====================  TEST 12 ====================\033[0m" << std::endl;
+    (void)debug;
+    AVLTree<int> tree;
+    for (int i = 1; i <= 100; ++i) {
+        tree.insert(i);
+    }
+
+    // remove zwraca informację, czy cokolwiek usunięto
+    assert(tree.remove(50));
+    assert(!tree.remove(50));
+    assert(!tree.remove(1000));
+    assert(tree.size() == 99);
+
+    // erase(iterator) zwraca następnik, a pozostałe iteratory pozostają ważne
+    AVLTree<int>::iterator keep = tree.find(98);
+    AVLTree<int>::iterator it = tree.begin();
+    while (it != tree.end()) {
+        if (*it % 3 == 0) {
+            it = tree.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    assert(tree.isValid());
+    assert(*keep == 98 && *++keep == 100);
+    for (int i = 1; i <= 100; ++i) {
+        assert(tree.search(i) == (i % 3 != 0 && i != 50));
+    }
+    keep = tree.find(100);
+    assert(tree.erase(keep) == tree.end());
+    assert(*tree.rbegin() == 98);
+}
+
+void test13(bool debug) {
+    std::cout << "\033[33m====================  TEST 13 ====================\033[0m" << std::endl;
+    (void)debug;
+    for (int n = 0; n <= 130; ++n) {
+        std::vector<int> sorted;
+        for (int i = 0; i < n; ++i) {
+            sorted.push_back(i * 3);
+        }
+        AVLTree<int> tree = AVLTree<int>::build_from_sorted(sorted.begin(), sorted.end(), true);
+        assert(tree.isValid());
+        assert(tree.size() == sorted.size());
+        assert(std::equal(tree.begin(), tree.end(), sorted.begin()));
+
+        // Drzewo jest idealnie zrównoważone: wysokość = ceil(log2(n + 1))
+        int expectedHeight = 0;
+        while ((1 << expectedHeight) < n + 1) ++expectedHeight;
+        assert(tree.getHeight() == expectedHeight);
+    }
+
+    // Zbudowane drzewo obsługuje zwykłe operacje
+    std::vector<int> sorted;
+    for (int i = 1; i <= 1000; ++i) {
+        sorted.push_back(i);
+    }
+    AVLTree<int> tree = AVLTree<int>::build_from_sorted(sorted.begin(), sorted.end());
+    tree.insert(0);
+    tree.remove(500);
+    assert(tree.isValid() && tree.size() == 1000 && tree.select(0) == 0);
+
+    // Kontrola posortowania danych wejściowych
+    int unsorted[] = {1, 3, 2};
+    int duplicates[] = {1, 2, 2};
+    try {
+        AVLTree<int>::build_from_sorted(unsorted, unsorted + 3, true);
+        assert(false); // Powinno rzucić wyjątek
+    } catch (const std::invalid_argument&) {
+        // Oczekiwany wyjątek
+    }
+    try {
+        AVLTree<int>::build_from_sorted(duplicates, duplicates + 3, true);
+        assert(false); // Powinno rzucić wyjątek
+    } catch (const std::invalid_argument&) {
+        // Oczekiwany wyjątek
+    }
+}
+
+// Buduje drzewo z losowych kluczy z zakresu [0, range) i zwraca posortowaną kopię kluczy
+std::vector<int> randomTree(AVLTree<int>& tree, int count, int range) {
+    std::vector<int> keys;
+    for (int i = 0; i < count; ++i) {
+        int key = std::rand() % range;
+        tree.insert(key);
+        keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+void test14(bool debug) {
+    std::cout << "\033[33m====================  TEST 14 ====================\033[0m" << std::endl;
+    (void)debug;
+    std::srand(2024);
+
+    // split i join
+    AVLTree<int> tree;
+    std::vector<int> keys = randomTree(tree, 2000, 5000);
+    AVLTree<int> less, greater;
+    int pivot = keys[keys.size() / 3];
+    assert(tree.split(pivot, less, greater));
+    assert(tree.empty() && less.isValid() && greater.isValid());
+    assert(less.size() == keys.size() / 3 && *less.rbegin() < pivot && *greater.begin() > pivot);
+    assert(less.size() + greater.size() + 1 == keys.size());
+    assert(!less.split(-1, less, greater) && less.empty() && greater.size() == keys.size() / 3);
+
+    tree.join(greater, pivot, less);  // pusty less po prawej stronie
+    assert(tree.isValid() && tree.size() == keys.size() / 3 + 1);
+
+    // join drzew o bardzo różnych wysokościach
+    AVLTree<int> small, big;
+    small.insert(-5);
+    for (int i = 0; i < 1000; ++i) {
+        big.insert(i);
+    }
+    small.join(small, -1, big);
+    assert(small.isValid() && small.size() == 1002 && big.empty());
+    try {
+        small.join(small, 0, big);
+        assert(false); // Powinno rzucić wyjątek
+    } catch (const std::invalid_argument&) {
+        // Oczekiwany wyjątek
+    }
+
+    // join2
+    AVLTree<int> low, high;
+    for (int i = 0; i < 300; ++i) {
+        low.insert(i);
+    }
+    for (int i = 300; i < 310; ++i) {
+        high.insert(i);
+    }
+    AVLTree<int> joined;
+    joined.join2(low, high);
+    assert(joined.isValid() && joined.size() == 310 && low.empty() && high.empty());
+    assert(std::distance(joined.begin(), joined.end()) == 310);
+
+    // Operacje na zbiorach porównane z algorytmami STL, także dla drzew z różnymi alokatorami
+    for (int round = 0; round < 20; ++round) {
+        int countA = 1 + std::rand() % 2000;
+        int countB = 1 + std::rand() % (round % 2 ? 20 : 2000);
+        PoolAllocator shared;
+        AVLTree<int> a(shared), b(round % 3 ? shared : PoolAllocator());
+        std::vector<int> keysA = randomTree(a, countA, 3000);
+        std::vector<int> keysB = randomTree(b, countB, 3000);
+        std::vector<int> expected;
+
+        AVLTree<int> u(a), other(b);
+        u.set_union(other);
+        std::set_union(keysA.begin(), keysA.end(), keysB.begin(), keysB.end(), std::back_inserter(expected));
+        assert(u.isValid() && other.empty());
+        assert(u.size() == expected.size() && std::equal(u.begin(), u.end(), expected.begin()));
+
+        AVLTree<int> in(a);
+        other = b;
+        in.set_intersection(other);
+        expected.clear();
+        std::set_intersection(keysA.begin(), keysA.end(), keysB.begin(), keysB.end(), std::back_inserter(expected));
+        assert(in.isValid() && other.empty());
+        assert(in.size() == expected.size() && std::equal(in.begin(), in.end(), expected.begin()));
+
+        a.set_difference(b);
+        expected.clear();
+        std::set_difference(keysA.begin(), keysA.end(), keysB.begin(), keysB.end(), std::back_inserter(expected));
+        assert(a.isValid() && b.empty());
+        assert(a.size() == expected.size() && std::equal(a.begin(), a.end(), expected.begin()));
+    }
+}
+
+void test15(bool debug) {
+    std::cout << "\033[33m====================  TEST 15 ====================\033[0m" << std::endl;
+    (void)debug;
+    std::srand(99);
+    const std::size_t cutoff = 64;
+
+    // Równoległe budowanie
+    std::vector<int> sorted;
+    for (int i = 0; i < 100000; ++i) {
+        sorted.push_back(i * 2);
+    }
+    AVLTree<int> built = AVLTree<int>::parallel_build_from_sorted(sorted.begin(), sorted.end(), true,
+                                                                  PoolAllocator(), cutoff);
+    assert(built.isValid() && built.size() == sorted.size());
+    assert(std::equal(built.begin(), built.end(), sorted.begin()));
+    // Typ, którego kopiowanie może rzucić wyjątek, jest budowany sekwencyjnie
+    std::vector<std::string> names;
+    names.push_back("a");
+    names.push_back("b");
+    names.push_back("c");
+    AVLTree<std::string> words = AVLTree<std::string>::parallel_build_from_sorted(names.begin(), names.end(), true);
+    assert(words.isValid() && words.size() == 3);
+
+    // Równoległa map-reduce (suma i liczba elementów parzystych podzielnych przez 3)
+    long long sum = built.parallel_map_reduce([](int v) { return static_cast<long long>(v); },
+                                              [](long long a, long long b) { return a + b; }, 0LL, cutoff);
+    assert(sum == 100000LL * 99999LL);
+    std::string concat = built.parallel_map_reduce([](int v) { return v < 10 ? std::to_string(v) : std::string(); },
+                                                   [](const std::string& a, const std::string& b) { return a + b; },
+                                                   std::string(), cutoff);
+    assert(concat == "02468");
+
+    // Równoległe filtrowanie
+    built.parallel_filter([](int v) { return v % 3 == 0; }, cutoff);
+    assert(built.isValid() && built.size() == 33334);
+    assert(std::all_of(built.begin(), built.end(), [](int v) { return v % 6 == 0; }));
+
+    // Równoległe operacje na zbiorach porównane z wersjami sekwencyjnymi
+    for (int round = 0; round < 5; ++round) {
+        PoolAllocator shared;
+        AVLTree<int> a(shared), b(shared);
+        randomTree(a, 20000, 50000);
+        randomTree(b, round % 2 ? 500 : 20000, 50000);
+
+        AVLTree<int> seq(a), seqOther(b), par(a), parOther(b);
+        seq.set_union(seqOther);
+        par.parallel_union(parOther, cutoff);
+        assert(par.isValid() && parOther.empty() && std::equal(par.begin(), par.end(), seq.begin()));
+        assert(par.size() == seq.size());
+
+        seq = a; seqOther = b; par = a; parOther = b;
+        seq.set_intersection(seqOther);
+        par.parallel_intersection(parOther, cutoff);
+        assert(par.isValid() && par.size() == seq.size() && std::equal(par.begin(), par.end(), seq.begin()));
+
+        seq = a; seqOther = b; par = a; parOther = b;
+        seq.set_difference(seqOther);
+        par.parallel_difference(parOther, cutoff);
+        assert(par.isValid() && par.size() == seq.size() && std::equal(par.begin(), par.end(), seq.begin()));
+    }
+}
+
+void test16(bool debug) {
+    std::cout << "\033[33m====================  TEST 16 ====================\033[0m" << std::endl;
+    (void)debug;
+    PersistentAVLTree<int> tree;
+    for (int i = 0; i < 1000; ++i) {
+        assert(tree.insert(i));
+    }
+    assert(!tree.insert(10));
+
+    // Migawka nie widzi późniejszych zmian
+    PersistentAVLTree<int>::Snapshot before = tree.snapshot();
+    for (int i = 0; i < 1000; i += 2) {
+        assert(tree.remove(i));
+    }
+    assert(!tree.remove(0));
+    assert(before.size() == 1000 && before.search(0) && before.isValid());
+    assert(tree.size() == 500 && !tree.search(0) && tree.search(1) && tree.isValid());
+    assert(before.select(10) == 10 && tree.snapshot().select(10) == 21);
+
+    // Kopia drzewa współdzieli strukturę i rozwija się niezależnie
+    PersistentAVLTree<int> copy(tree);
+    copy.insert(-1);
+    assert(copy.size() == 501 && tree.size() == 500);
+    long long sum = 0;
+    copy.snapshot().for_each([&sum](int v) { sum += v; });
+    assert(sum == 250000 - 1);
+
+    // Czytelnicy pobierają migawki równolegle z piszącym
+    std::atomic<bool> done(false);
+    std::atomic<int> checks(0);
+    std::thread reader([&] {
+        std::size_t last = 0;
+        while (!done.load()) {
+            PersistentAVLTree<int>::Snapshot view = tree.snapshot();
+            assert(view.size() >= last);
+            last = view.size();
+            assert(view.empty() || view.search(view.select(0)));
+            ++checks;
+        }
+    });
+    for (int i = 1000; i < 5000; ++i) {
+        tree.insert(i);
+    }
+    done.store(true);
+    reader.join();
+    assert(checks.load() > 0);
+    assert(tree.size() == 4500 && tree.isValid());
+    tree.clear();
+    assert(tree.empty() && copy.size() == 501);
+}
+
+void test17(bool debug) {
+    std::cout << "\033[33m====================  TEST 17 ====================\033[0m" << std::endl;
+    (void)debug;
+    ConcurrentAVLTree<int> tree(16);
+    const int threads = 4;
+    const int perThread = 5000;
+
+    // Każdy wątek wstawia własny zakres kluczy, usuwa co drugi i szuka cudzych kluczy
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&tree, t, perThread] {
+            int base = t * perThread;
+            for (int i = 0; i < perThread; ++i) {
+                assert(tree.insert(base + i));
+                tree.search((base + i * 7) % (4 * perThread));
+            }
+            for (int i = 0; i < perThread; i += 2) {
+                assert(tree.remove(base + i));
+            }
+        }));
+    }
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+    assert(tree.isValid());
+    assert(tree.size() == static_cast<std::size_t>(threads * perThread / 2));
+    for (int key = 0; key < threads * perThread; ++key) {
+        assert(tree.search(key) == (key % 2 == 1));
+    }
+    tree.clear();
+    assert(tree.empty());
+}
+
+void test18(bool debug) {
+    std::cout << "\033[33m====================  TEST 18 ====================\033[0m" << std::endl;
+    // Przezroczysty komparator pozwala szukać kluczem std::string_view
+    AVLMap<std::string, int, std::less<> > counts;
+    const char* words[] = { "drzewo", "avl", "węzeł", "avl", "rotacja", "drzewo", "avl" };
+    for (const char* word : words) {
+        ++counts[word];
+    }
+    if (debug) {
+        for (AVLMap<std::string, int, std::less<> >::const_iterator it = counts.begin(); it != counts.end(); ++it) {
+            std::cout << it->first << ": " << it->second << std::endl;
+        }
+    }
+    assert(counts.size() == 4 && counts.isValid());
+    std::string_view key = "avl";
+    assert(counts.find(key) != counts.end() && counts.find(key)->second == 3);
+    assert(counts.count(std::string_view("drzewo")) == 1 && counts.count(std::string_view("las")) == 0);
+    assert(counts.at("rotacja") == 1);
+
+    // try_emplace nie nadpisuje, insert_or_assign nadpisuje istniejącą wartość
+    assert(!counts.try_emplace("avl", 100).second && counts.at("avl") == 3);
+    assert(counts.try_emplace("las", 7).second && counts.at("las") == 7);
+    assert(!counts.insert_or_assign("las", 8).second && counts.at("las") == 8);
+    assert(counts.insert_or_assign("korzeń", 9).second && counts.size() == 6);
+    bool thrown = false;
+    try {
+        counts.at("liść");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Klucze w kolejności rosnącej, a wartości można zmieniać przez iterator
+    std::string previous;
+    for (AVLMap<std::string, int, std::less<> >::iterator it = counts.begin(); it != counts.end(); ++it) {
+        assert(previous < it->first);
+        previous = it->first;
+        it->second *= 10;
+    }
+    assert(counts.at("węzeł") == 10);
+    assert(counts.erase("węzeł") == 1 && counts.erase("węzeł") == 0);
+    assert(counts.erase(counts.find(key))->first == "drzewo");
+    assert(counts.size() == 4 && counts.isValid());
+
+    // Wartości bez konstruktora kopiującego tworzone są w miejscu
+    AVLMap<int, std::vector<int> > lists;
+    for (int i = 0; i < 100; ++i) {
+        lists.try_emplace(i % 10, 3, i);
+        lists[i % 10].push_back(i);
+    }
+    assert(lists.size() == 10 && lists.isValid());
+    assert(lists.at(4).size() == 13 && lists.at(4)[0] == 4 && lists.at(4).back() == 94);
+    assert(lists.lower_bound(5)->first == 5 && lists.upper_bound(9) == lists.end());
+}
+
+// Typ zliczający kopie - ścieżka zapisu nie powinna go kopiować
+struct Payload {
+    static int copies;
+    int key;
+    std::vector<int> data;
+
+    Payload(int key, std::size_t length) : key(key), data(length, key) {}
+    Payload(const Payload& other) : key(other.key), data(other.data) { ++copies; }
+    Payload(Payload&&) = default;
+    Payload& operator=(const Payload&) = delete;
+
+    bool operator<(const Payload& other) const { return key < other.key; }
+};
+
+int Payload::copies = 0;
+
+AVLTree<int> makeTree(int count) {
+    AVLTree<int> tree;
+    for (int i = 0; i < count; ++i) {
+        tree.insert(i);
+    }
+    return tree;
+}
+
+void test19(bool debug) {
+    std::cout << "\033[33m====================  TEST 19 ====================\033[0m" << std::endl;
+    (void)debug;
+    // insert(T&&) i emplace nie kopiują wartości
+    AVLTree<Payload> payloads;
+    for (int i = 0; i < 50; ++i) {
+        Payload p(i, 100);
+        payloads.insert(std::move(p));
+        assert(p.data.empty());
+        assert(payloads.emplace(i + 100, 100).second);
+    }
+    assert(!payloads.emplace(7, 1).second && payloads.find(Payload(7, 0))->data.size() == 100);
+    assert(Payload::copies == 0 && payloads.size() == 100 && payloads.isValid());
+
+    // Kopia jest niezależna, a kopiowanie drzewa kopiuje każdą wartość dokładnie raz
+    AVLTree<Payload> payloadsCopy(payloads);
+    assert(Payload::copies == 100 && payloadsCopy.isValid());
+
+    // Przenoszenie przejmuje węzły, a źródło pozostaje używalnym pustym drzewem
+    static_assert(std::is_nothrow_move_constructible<AVLTree<int> >::value, "move ctor");
+    static_assert(std::is_nothrow_move_assignable<AVLTree<int> >::value, "move assign");
+    AVLTree<int> source = makeTree(1000);
+    const int* first = &*source.begin();
+    AVLTree<int> moved(std::move(source));
+    assert(source.empty() && moved.size() == 1000 && &*moved.begin() == first);
+    source.insert(5);
+    assert(source.size() == 1 && source.isValid());
+
+    AVLTree<int> target = makeTree(10);
+    target = std::move(moved);
+    assert(moved.empty() && target.size() == 1000 && target.isValid());
+
+    // swap wymienia zawartość w czasie O(1)
+    swap(source, target);
+    assert(source.size() == 1000 && target.size() == 1 && target.search(5));
+
+    // Przypisanie kopiujące klonuje drzewo, zachowując kształt i wysokości
+    AVLTree<int> assigned = makeTree(3);
+    assigned = source;
+    assert(assigned.size() == 1000 && assigned.isValid() && assigned.getHeight() == source.getHeight());
+    assigned.remove(10);
+    assert(source.search(10) && !assigned.search(10));
+    assigned = assigned;
+    assert(assigned.size() == 999);
+
+    AVLMap<std::string, int> a, b;
+    a["avl"] = 1;
+    b = a;
+    AVLMap<std::string, int> c(std::move(a));
+    assert(a.empty() && b.at("avl") == 1 && c.at("avl") == 1);
+}
+
+void test20(bool debug) {
+    std::cout << "\033[33m====================  TEST 20 ====================\033[0m" << std::endl;
+    // Losowe wstawianie i usuwanie porównywane z std::set
+    CompactAVLTree<int> compact;
+    AVLTree<int> regular;
+    std::set<int> reference;
+    std::srand(2024);
+    for (int i = 0; i < 20000; ++i) {
+        int value = std::rand() % 5000;
+        if (std::rand() % 3) {
+            assert(compact.insert(value) == reference.insert(value).second);
+            regular.insert(value);
+        } else {
+            assert(compact.remove(value) == (reference.erase(value) == 1));
+            regular.remove(value);
+        }
+    }
+    assert(compact.isValid() && compact.size() == reference.size());
+    std::vector<int> inorder;
+    compact.for_each([&inorder](int value) { inorder.push_back(value); });
+    assert(std::equal(inorder.begin(), inorder.end(), reference.begin()) && inorder.size() == reference.size());
+    for (int value = 0; value < 5000; ++value) {
+        assert(compact.search(value) == (reference.count(value) == 1));
+    }
+
+    // Węzeł zwarty jest dużo mniejszy od węzła ze wskaźnikami
+    MemoryUsage compactUsage = compact.memory_usage();
+    MemoryUsage regularUsage = regular.memory_usage();
+    assert(compactUsage.nodes == regularUsage.nodes);
+    assert(compactUsage.bytesPerNode == 16 && compactUsage.bytesPerNode < regularUsage.bytesPerNode);
+    if (debug) {
+        std::cout << "AVLTree<int>:        " << regularUsage.bytesPerNode << " B/węzeł, narzut "
+                  << regularUsage.overheadPerNode << " B, razem " << regularUsage.totalBytes << " B" << std::endl;
+        std::cout << "CompactAVLTree<int>: " << compactUsage.bytesPerNode << " B/węzeł, narzut "
+                  << compactUsage.overheadPerNode << " B, razem " << compactUsage.totalBytes << " B" << std::endl;
+    }
+
+    // Zwolnione miejsca są używane ponownie
+    std::size_t capacity = compactUsage.totalBytes;
+    for (int value = 0; value < 5000; ++value) compact.remove(value);
+    assert(compact.empty() && compact.getHeight() == 0);
+    for (int value = 0; value < static_cast<int>(reference.size()); ++value) compact.insert(value);
+    assert(compact.memory_usage().totalBytes == capacity && compact.isValid());
+
+    CompactAVLTree<std::string> words;
+    assert(words.insert("drzewo") && words.insert(std::string("avl")) && !words.insert("avl"));
+    assert(words.remove("drzewo") && words.search("avl") && words.size() == 1);
+}
+
+void test21(bool debug) {
+    std::cout << "\033[33m====================  TEST 21 ====================\033[0m" << std::endl;
+    (void)debug;
+    AVLTree<int> tree;
+    std::vector<int> values = randomTree(tree, 3000, 10000);
+    FrozenAVL<int> frozen = tree.freeze();
+    assert(frozen.size() == tree.size());
+
+    // Wyniki zamrożonej kopii zgadzają się z drzewem dla trafień, chybień i wartości skrajnych
+    for (int value = -1; value <= 10001; ++value) {
+        assert(frozen.search(value) == tree.search(value));
+        const int* bound = frozen.lower_bound(value);
+        AVLTree<int>::iterator it = tree.lower_bound(value);
+        assert(it == tree.end() ? bound == nullptr : bound && *bound == *it);
+    }
+
+    // Zmiany drzewa nie dotyczą kopii, a kopię można przeszukiwać z wielu wątków
+    int removed = tree.find_min();
+    tree.remove(removed);
+    assert(!tree.search(removed) && frozen.search(removed));
+    std::atomic<int> found(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.push_back(std::thread([&frozen, &values, &found] {
+            int hits = 0;
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                hits += frozen.search(values[i]);
+            }
+            found += hits;
+        }));
+    }
+    for (std::size_t i = 0; i < readers.size(); ++i) {
+        readers[i].join();
+    }
+    assert(found == static_cast<int>(4 * values.size()));
+
+    AVLTree<int> empty;
+    assert(empty.freeze().empty() && !empty.freeze().search(1) && !empty.freeze().lower_bound(1));
+    AVLTree<std::string> words;
+    words.insert("drzewo");
+    words.insert("avl");
+    words.insert("węzeł");
+    FrozenAVL<std::string> frozenWords = words.freeze();
+    assert(frozenWords.search("avl") && !frozenWords.search("las") && *frozenWords.lower_bound("b") == "drzewo");
+}
+
+void test22(bool debug) {
+    std::cout << "\033[33m====================  TEST 22 ====================\033[0m" << std::endl;
+    (void)debug;
+    AVLTree<int> tree;
+    randomTree(tree, 2000, 4000);
+
+    // Wyniki wsadowe zgadzają się z pojedynczymi wyszukiwaniami, także dla niepełnej grupy
+    std::vector<int> keys;
+    for (int value = -3; value < 4003; value += 3) {
+        keys.push_back(value);
+    }
+    std::vector<bool> found(keys.size());
+    std::vector<AVLTree<int>::iterator> its(keys.size());
+    tree.search_batch(keys.begin(), keys.end(), found.begin());
+    tree.find_batch(keys.begin(), keys.end(), its.begin());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        assert(found[i] == tree.search(keys[i]));
+        assert(its[i] == tree.find(keys[i]));
+    }
+
+    // Puste drzewo i pusty zakres
+    AVLTree<int> empty;
+    bool results[3] = { true, true, true };
+    empty.search_batch(keys.begin(), keys.begin() + 3, results);
+    assert(!results[0] && !results[1] && !results[2]);
+    tree.search_batch(keys.begin(), keys.begin(), results);
+}
+
+// Wartość, której kopiowanie rzuca wyjątek, gdy licznik dozwolonych kopii spadnie do zera
+struct FragileValue {
+    static int copiesLeft;
+    int key;
+
+    FragileValue(int key) : key(key) {}
+    FragileValue(const FragileValue& other) : key(other.key) {
+        if (copiesLeft-- == 0) throw std::runtime_error("kopia");
+    }
+    FragileValue& operator=(const FragileValue&) = default;
+    bool operator<(const FragileValue& other) const { return key < other.key; }
+};
+
+int FragileValue::copiesLeft = -1;
+
+void test23(bool debug) {
+    std::cout << "\033[33m====================  TEST 23 ====================\033[0m" << std::endl;
+    (void)debug;
+    std::srand(7);
+    AVLTree<int> tree;
+    std::set<int> reference;
+    randomTree(tree, 500, 20000);
+    reference.insert(tree.begin(), tree.end());
+    for (int round = 0; round < 20; ++round) {
+        // Paczki w losowej kolejności, z powtórzeniami i kluczami już obecnymi w drzewie
+        std::vector<int> batch;
+        for (int i = 0; i < 1500; ++i) {
+            batch.push_back(std::rand() % 20000);
+        }
+        std::size_t expected = 0;
+        if (round % 3 == 2) {
+            for (std::size_t i = 0; i < batch.size(); ++i) expected += reference.erase(batch[i]);
+            assert(tree.erase_batch(batch.begin(), batch.end()) == expected);
+        } else {
+            for (std::size_t i = 0; i < batch.size(); ++i) expected += reference.insert(batch[i]).second;
+            assert(tree.insert_batch(batch.begin(), batch.end()) == expected);
+        }
+        assert(tree.isValid() && tree.size() == reference.size());
+        assert(std::equal(tree.begin(), tree.end(), reference.begin()));
+    }
+
+    // Pusty zakres, puste drzewo i usuwanie wszystkiego
+    std::vector<int> none;
+    assert(tree.insert_batch(none.begin(), none.end()) == 0 && tree.size() == reference.size());
+    AVLTree<int> fresh;
+    int values[] = { 5, 3, 9, 3, 1 };
+    assert(fresh.insert_batch(values, values + 5) == 4 && fresh.isValid() && fresh.size() == 4);
+    assert(fresh.erase_batch(values, values + 5) == 4 && fresh.empty());
+
+    // Wyjątek kopiowania w środku wstawiania wsadowego zostawia poprawne drzewo ze starymi elementami
+    AVLTree<FragileValue> fragile;
+    for (int i = 0; i < 200; i += 2) fragile.insert(FragileValue(i));
+    for (int limit = 0; limit < 400; limit += 7) {
+        std::vector<FragileValue> batch;
+        for (int i = 1; i < 200; i += 2) batch.push_back(FragileValue(i));
+        FragileValue::copiesLeft = limit;
+        try {
+            fragile.insert_batch(batch.begin(), batch.end());
+        } catch (const std::runtime_error&) {
+        }
+        FragileValue::copiesLeft = -1;
+        assert(fragile.isValid());
+        for (int i = 0; i < 200; i += 2) assert(fragile.search(FragileValue(i)));
+        fragile.erase_batch(batch.begin(), batch.end());
+        assert(fragile.isValid() && fragile.size() == 100);
+    }
+}
+
+void test24(bool debug) {
+    std::cout << "\033[33m====================  TEST 24 ====================\033[0m" << std::endl;
+    (void)debug;
+    // Bez AVLTREE_STATS liczniki nie istnieją - migawka ma same zera, ale histogram głębokości jest liczony
+    AVLTree<int> tree;
+    for (int i = 1; i <= 7; ++i) tree.insert(i);
+    assert(tree.search(4) && !tree.search(8));
+    AVLStats stats = tree.stats();
+    assert(!stats.enabled);
+    assert(stats.singleRotations == 0 && stats.doubleRotations == 0 && stats.searches == 0);
+    assert(stats.allocations == 0 && stats.frees == 0 && stats.updates == 0);
+    assert(stats.comparisonsPerSearch() == 0.0);
+    assert(stats.depthHistogram == std::vector<std::size_t>({ 1, 2, 4 }));
+    tree.reset_stats();
+    std::string json = stats.to_json();
+    assert(json.find("\"enabled\": false") != std::string::npos);
+    assert(json.find("\"depth_histogram\": [1, 2, 4]") != std::string::npos);
+}
+
+// Obserwator zapisujący zdarzenia zamiast je wypisywać
+struct RecordingObserver {
+    int leftRotations = 0, rightRotations = 0;
+    std::vector<int> inserted, erased;
+    std::size_t sizeAfterErase = 0;
+
+    void on_rotate(int, AVLRotation direction) {
+        ++(direction == AVLRotation::Left ? leftRotations : rightRotations);
+    }
+
+    template <typename Tree>
+    void on_insert(const Tree&, int value) { inserted.push_back(value); }
+
+    template <typename Tree>
+    void on_erase(const Tree& tree, int value) {
+        erased.push_back(value);
+        sizeAfterErase = tree.size();
+    }
+};
+
+void test25(bool debug) {
+    std::cout << "\033[33m====================  TEST 25 ====================\033[0m" << std::endl;
+    (void)debug;
+    AVLTree<int, std::less<int>, PoolAllocator, RecordingObserver> tree;
+    tree.insert(1);
+    tree.insert(2);
+    tree.insert(3); // RR - rotacja w lewo
+    tree.insert(0);
+    tree.insert(-1); // LL - rotacja w prawo
+    tree.insert(3); // duplikat nie jest zgłaszany
+    assert(tree.get_observer().leftRotations == 1 && tree.get_observer().rightRotations == 1);
+    assert(tree.get_observer().inserted == std::vector<int>({ 1, 2, 3, 0, -1 }));
+    assert(tree.emplace(10).second && tree.get_observer().inserted.back() == 10);
+
+    assert(tree.remove(2) && !tree.remove(2));
+    assert(tree.get_observer().erased == std::vector<int>({ 2 }));
+    assert(tree.get_observer().sizeAfterErase == 5 && tree.isValid());
+
+    // Obserwator śledzący wypisuje komunikaty i drzewo do podanego strumienia
+    std::ostringstream trace;
+    TracedTree traced{ TracingObserver(&trace) };
+    traced.insert(3);
+    traced.insert(2);
+    traced.insert(1);
+    traced.remove(3);
+    std::string text = trace.str();
+    assert(text.find("Rotacja w prawo węzła: 3") != std::string::npos);
+    assert(text.find("Wstawiono węzeł: 1") != std::string::npos);
+    assert(text.find("Usunięto węzeł: 3") != std::string::npos);
+    assert(text.find("---2") != std::string::npos);
+}
+
+void test26(bool debug) {
+    std::cout << "\033[33m====================  TEST 26 ====================\033[0m" << std::endl;
+    (void)debug;
+    const std::string path = "avl_snapshot_test.bin";
+    std::srand(11);
+    AVLTree<int> tree;
+    std::vector<int> keys = randomTree(tree, 5000, 100000);
+    for (int i = 0; i < 2000; i += 3) tree.remove(keys[i]);
+    tree.save(path);
+
+    // load() odtwarza ten sam kształt drzewa, a nie tylko te same elementy
+    AVLTree<int> loaded = AVLTree<int>::load(path);
+    assert(loaded.isValid() && loaded.size() == tree.size());
+    assert(std::equal(loaded.begin(), loaded.end(), tree.begin()));
+    assert(loaded.top() == tree.top() && loaded.getHeight() == tree.getHeight());
+    assert(loaded.stats().depthHistogram == tree.stats().depthHistogram);
+
+    // Widok zmapowany przeszukuje plik w miejscu
+    {
+        MappedAVL<int> mapped(path);
+        assert(mapped.size() == tree.size());
+        for (int key = -10; key < 100010; key += 7) {
+            assert(mapped.search(key) == tree.search(key));
+        }
+        assert(*mapped.find(tree.find_min()) == tree.find_min());
+    }
+
+    // Uszkodzony rozmiar poddrzewa nie wyprowadza poza tablice
+    {
+        std::fstream file(path.c_str(), std::ios::binary | std::ios::in | std::ios::out);
+        std::uint32_t broken = 0xFFFFFFFFu;
+        file.seekp(static_cast<std::streamoff>(makeSnapshotHeader<int>(tree.size()).leftSizesOffset));
+        file.write(reinterpret_cast<const char*>(&broken), sizeof(broken));
+    }
+    assert(!MappedAVL<int>(path).search(tree.top()));
+    bool rejected = false;
+    try {
+        AVLTree<int>::load(path);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+
+    // Plik z innym typem elementów jest odrzucany
+    rejected = false;
+    try {
+        AVLTree<long long>::load(path);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+    rejected = false;
+    try {
+        MappedAVL<double> wrongType(path);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+
+    // Puste drzewo i brakujący plik
+    AVLTree<int> empty;
+    empty.save(path);
+    assert(AVLTree<int>::load(path).empty() && MappedAVL<int>(path).empty());
+    std::remove(path.c_str());
+    rejected = false;
+    try {
+        AVLTree<int>::load(path);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+}
+
+// Monoid nieprzemienny - sklejanie napisów sprawdza kolejność składania agregatów
+struct ConcatAugment {
+    typedef std::string value_type;
+    static value_type identity() { return std::string(); }
+    static value_type lift(int value) { return std::to_string(value) + ","; }
+    static value_type combine(const value_type& a, const value_type& b) { return a + b; }
+};
+
+void test27(bool debug) {
+    std::cout << "\033[33m====================  TEST 27 ====================\033[0m" << std::endl;
+    (void)debug;
+    typedef AVLTree<int, std::less<int>, PoolAllocator, NullObserver, SumAugment<int, long long> > SumTree;
+    std::srand(5);
+    SumTree tree;
+    std::set<int> reference;
+    for (int round = 0; round < 6; ++round) {
+        // Agregaty muszą przetrwać wstawianie, usuwanie, operacje wsadowe i kopiowanie
+        for (int i = 0; i < 400; ++i) {
+            int key = std::rand() % 5000;
+            if (std::rand() % 3) {
+                tree.insert(key);
+                reference.insert(key);
+            } else {
+                tree.remove(key);
+                reference.erase(key);
+            }
+        }
+        std::vector<int> batch;
+        for (int i = 0; i < 300; ++i) batch.push_back(std::rand() % 5000);
+        if (round % 2) {
+            tree.erase_batch(batch.begin(), batch.end());
+            for (std::size_t i = 0; i < batch.size(); ++i) reference.erase(batch[i]);
+        } else {
+            tree.insert_batch(batch.begin(), batch.end());
+            reference.insert(batch.begin(), batch.end());
+        }
+        SumTree copy(tree);
+        for (int q = 0; q < 200; ++q) {
+            int lo = std::rand() % 5200 - 100;
+            int hi = lo + std::rand() % 1500;
+            long long expected = 0;
+            for (std::set<int>::iterator it = reference.lower_bound(lo); it != reference.end() && *it <= hi; ++it) {
+                expected += *it;
+            }
+            assert(tree.range_aggregate(lo, hi) == expected);
+            assert(copy.range_aggregate(lo, hi) == expected);
+        }
+        assert(tree.aggregate() == std::accumulate(reference.begin(), reference.end(), 0LL));
+        assert(tree.range_aggregate(10, 5) == 0);
+    }
+
+    // Łączenie i podział drzew też poprawiają agregaty
+    SumTree less, greater;
+    tree.split(2500, less, greater);
+    assert(less.aggregate() + greater.aggregate() + (reference.count(2500) ? 2500 : 0) ==
+           std::accumulate(reference.begin(), reference.end(), 0LL));
+    tree.join2(less, greater);
+    assert(tree.range_aggregate(0, 2499) == std::accumulate(reference.begin(), reference.lower_bound(2500), 0LL));
+
+    AVLTree<int, std::less<int>, PoolAllocator, NullObserver, ConcatAugment> ordered;
+    for (int i = 10; i >= 1; --i) ordered.insert(i);
+    assert(ordered.range_aggregate(3, 7) == "3,4,5,6,7,");
+    assert(ordered.aggregate() == "1,2,3,4,5,6,7,8,9,10,");
+
+    AVLTree<int, std::less<int>, PoolAllocator, NullObserver, MaxAugment<int> > maxTree;
+    for (int i = 0; i < 100; ++i) maxTree.insert((i * 37) % 100);
+    assert(maxTree.range_aggregate(20, 55) == 55 && maxTree.aggregate() == 99);
+
+    // Drzewo przedziałów: pary (początek, koniec) z największym końcem w poddrzewie
+    typedef std::pair<int, int> Interval;
+    AVLTree<Interval, std::less<Interval>, PoolAllocator, NullObserver, IntervalMaxEndAugment<int> > intervals;
+    std::vector<Interval> all;
+    for (int i = 0; i < 500; ++i) {
+        int start = std::rand() % 10000;
+        Interval interval(start, start + std::rand() % 300);
+        intervals.insert(interval);
+        all.push_back(interval);
+    }
+    std::sort(all.begin(), all.end());
+    all.erase(std::unique(all.begin(), all.end()), all.end());
+    for (int q = 0; q < 100; ++q) {
+        int lo = std::rand() % 10000;
+        int hi = lo + std::rand() % 200;
+        std::vector<Interval> found, expected;
+        intervals.for_each_overlap(lo, hi, [&found](const Interval& interval) { found.push_back(interval); });
+        for (std::size_t i = 0; i < all.size(); ++i) {
+            if (all[i].first <= hi && all[i].second >= lo) expected.push_back(all[i]);
+        }
+        assert(found == expected);
+    }
+}
+
+void test28(bool debug) {
+    std::cout << "\033[33m====================  TEST 28 ====================\033[0m" << std::endl;
+    (void)debug;
+    // Zwykłe drzewo zgłasza teraz odrzucone duplikaty
+    AVLTree<int> set;
+    assert(set.insert(5) && !set.insert(5) && set.size() == 1);
+
+    // Wielozbiór porównywany z std::multiset przy małym zakresie kluczy (dużo powtórzeń)
+    AVLMultiset<int> bag;
+    std::multiset<int> reference;
+    std::srand(28);
+    for (int i = 0; i < 20000; ++i) {
+        int key = std::rand() % 50;
+        int op = std::rand() % 10;
+        if (op < 6) {
+            reference.insert(key);
+            assert(bag.insert(key) == reference.count(key));
+        } else if (op < 9) {
+            std::multiset<int>::iterator it = reference.find(key);
+            assert(bag.remove_one(key) == (it != reference.end()));
+            if (it != reference.end()) reference.erase(it);
+        } else {
+            assert(bag.remove_all(key) == reference.erase(key));
+        }
+    }
+    assert(bag.isValid());
+    assert(bag.size() == reference.size());
+    assert(bag.distinct() <= 50);
+    for (int key = -1; key <= 50; ++key) assert(bag.count(key) == reference.count(key));
+    std::size_t seen = 0;
+    int previous = -1;
+    for (AVLMultiset<int>::const_iterator it = bag.begin(); it != bag.end(); ++it) {
+        assert(it->first > previous && it->second == reference.count(it->first));
+        previous = it->first;
+        seen += it->second;
+    }
+    assert(seen == reference.size());
+
+    // Milion wystąpień jednego klucza zajmuje jeden węzeł
+    AVLMultiset<std::string, std::less<> > words;
+    for (int i = 0; i < 1000000; ++i) words.insert("avl");
+    assert(words.insert(std::string("drzewo")) == 1);
+    assert(words.size() == 1000001 && words.distinct() == 2);
+    assert(words.count(std::string_view("avl")) == 1000000);
+    assert(words.remove_one("drzewo") && words.count("drzewo") == 0 && words.distinct() == 1);
+    assert(words.lower_bound("b") == words.end() && words.find("avl")->second == 1000000);
+    words.clear();
+    assert(words.empty() && words.size() == 0);
+
+    // Przeniesienie zabiera licznik wystąpień razem z węzłami
+    AVLMultiset<int> source;
+    source.insert(1);
+    source.insert(1);
+    source.insert(2);
+    AVLMultiset<int> moved(std::move(source));
+    assert(moved.size() == 3 && !moved.empty() && moved.isValid());
+    assert(source.size() == 0 && source.empty() && source.isValid());
+    AVLMultiset<int> target;
+    for (int i = 0; i < 5; ++i) target.insert(7);
+    target = std::move(moved);
+    assert(target.size() == 3 && target.count(7) == 0 && target.count(1) == 2 && target.isValid());
+    assert(moved.size() == 0 && moved.empty() && moved.isValid());
+    AVLMultiset<int> copy(target);
+    copy = target;
+    assert(copy.size() == 3 && copy.isValid() && target.size() == 3);
+}
+
+void test29(bool debug) {
+    std::cout << "\033[33m====================  TEST 29 ====================\033[0m" << std::endl;
+    (void)debug;
+    // Dopisywanie rosnących kluczy z podpowiedzią end()
+    const int count = 100000;
+    AVLTree<int> appended;
+    for (int i = 0; i < count; ++i) appended.insert(appended.end(), i);
+    assert(appended.isValid() && appended.size() == static_cast<std::size_t>(count));
+
+    // To samo malejąco z podpowiedzią begin()
+    AVLTree<int> prepended;
+    for (int i = count; i > 0; --i) prepended.insert(prepended.begin(), i);
+    assert(prepended.isValid() && prepended.size() == static_cast<std::size_t>(count));
+
+    // Prawie uporządkowane znaczniki czasu: podpowiedzią jest poprzednio wstawiony element
+    AVLTree<long long> timestamps;
+    std::set<long long> reference;
+    std::srand(29);
+    AVLTree<long long>::iterator finger = timestamps.end();
+    for (long long t = 0; t < count; ++t) {
+        long long stamp = t * 4 - std::rand() % 32;
+        finger = timestamps.insert(finger, stamp);
+        assert(*finger == stamp);
+        reference.insert(stamp);
+    }
+    assert(timestamps.isValid() && timestamps.size() == reference.size());
+    assert(std::equal(timestamps.begin(), timestamps.end(), reference.begin()));
+
+    // Podpowiedź daleko od celu i duplikaty też dają poprawny wynik
+    AVLTree<int> tree;
+    for (int i = 0; i < 1000; i += 2) tree.insert(i);
+    AVLTree<int>::iterator low = tree.find(0);
+    assert(*tree.insert(low, 999) == 999 && tree.size() == 501);
+    assert(*tree.insert(tree.end(), 500) == 500 && tree.size() == 501);
+    assert(*tree.insert(tree.find(998), 1) == 1);
+    assert(tree.find(low, 998) != tree.end() && *tree.find(tree.end(), 2) == 2);
+    assert(tree.find(low, 997) == tree.end() && tree.find(tree.end(), -1) == tree.end());
     assert(tree.isValid());
+    AVLTree<int> empty;
+    assert(*empty.insert(empty.end(), 7) == 7 && empty.find(empty.end(), 7) == empty.begin());
+}
+
+// Sprawdza, czy ciąg może być przejściem preorder drzewa BST (klasyczny test ze stosem)
+bool isBstPreorder(const std::vector<int>& sequence) {
+    std::vector<int> stack;
+    long long low = std::numeric_limits<long long>::min();
+    for (std::size_t i = 0; i < sequence.size(); ++i) {
+        if (sequence[i] < low) return false;
+        while (!stack.empty() && stack.back() < sequence[i]) {
+            low = stack.back();
+            stack.pop_back();
+        }
+        stack.push_back(sequence[i]);
+    }
+    return true;
+}
+
+void test30(bool debug) {
+    std::cout << "\033[33m====================  TEST 30 ====================\033[0m" << std::endl;
+    (void)debug;
+    // Wstawienie 1..7 daje pełne drzewo o korzeniu 4
+    AVLTree<int> small;
+    for (int i = 1; i <= 7; ++i) small.insert(i);
+    std::vector<int> in, pre, post, level;
+    assert(small.for_each_inorder([&in](int value) { in.push_back(value); }));
+    assert(small.for_each_preorder([&pre](int value) { pre.push_back(value); }));
+    assert(small.for_each_postorder([&post](int value) { post.push_back(value); }));
+    assert(small.for_each_level([&level](int value) { level.push_back(value); }));
+    assert((in == std::vector<int>{1, 2, 3, 4, 5, 6, 7}));
+    assert((pre == std::vector<int>{4, 2, 1, 3, 6, 5, 7}));
+    assert((post == std::vector<int>{1, 3, 2, 5, 7, 6, 4}));
+    assert((level == std::vector<int>{4, 2, 6, 1, 3, 5, 7}));
+
+    // Visitor zwracający false przerywa przejście po podanej liczbie elementów
+    int seen = 0;
+    assert(!small.for_each_level([&seen](int) { return ++seen < 3; }) && seen == 3);
+    seen = 0;
+    assert(!small.for_each_postorder([&seen](int value) { ++seen; return value != 2; }) && seen == 3);
+
+    // Losowe drzewo: każde przejście odwiedza każdy element dokładnie raz
+    AVLTree<int> tree;
+    randomTree(tree, 5000, 100000);
+    std::vector<int> sorted(tree.begin(), tree.end());
+    in.clear(); pre.clear(); post.clear(); level.clear();
+    tree.for_each_inorder([&in](int value) { in.push_back(value); });
+    tree.for_each_preorder([&pre](int value) { pre.push_back(value); });
+    tree.for_each_postorder([&post](int value) { post.push_back(value); });
+    tree.for_each_level([&level](int value) { level.push_back(value); });
+    assert(in == sorted);
+    assert(pre.front() == tree.top() && post.back() == tree.top() && level.front() == tree.top());
+    assert(isBstPreorder(pre));
+    // Postorder czytany od końca to preorder drzewa odbitego (prawe poddrzewo przed lewym)
+    std::vector<int> mirrored(post.rbegin(), post.rend());
+    for (std::size_t i = 0; i < mirrored.size(); ++i) mirrored[i] = -mirrored[i];
+    assert(isBstPreorder(mirrored));
+    std::sort(pre.begin(), pre.end());
+    std::sort(post.begin(), post.end());
+    std::sort(level.begin(), level.end());
+    assert(pre == sorted && post == sorted && level == sorted);
+
+    AVLTree<int> empty;
+    assert(empty.for_each_inorder([](int) { return false; }) && empty.for_each_level([](int) { return false; }));
+}
+
+void test31(bool debug) {
+    std::cout << "\033[33m====================  TEST 31 ====================\033[0m" << std::endl;
+    (void)debug;
+    const std::size_t cutoff = 256;
+    std::vector<int> sorted(50000);
+    std::iota(sorted.begin(), sorted.end(), 0);
+
+    // Wyjątek z predykatu parallel_filter zwalnia wszystkie węzły i zostawia puste drzewo
+    AVLTree<int> tree = AVLTree<int>::parallel_build_from_sorted(sorted.begin(), sorted.end(), true,
+                                                                 PoolAllocator(), cutoff);
+    bool thrown = false;
+    try {
+        tree.parallel_filter([](int v) {
+            if (v == 31337) throw std::runtime_error("predykat");
+            return v % 2 == 0;
+        }, cutoff);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && tree.empty() && tree.isValid());
+    tree.insert(1);
+    assert(tree.size() == 1);
+
+    // Wyjątek z map w parallel_map_reduce nie zmienia drzewa
+    AVLTree<int> source = AVLTree<int>::build_from_sorted(sorted.begin(), sorted.end());
+    thrown = false;
+    try {
+        source.parallel_map_reduce([](int v) {
+            if (v == 4242) throw std::runtime_error("map");
+            return v;
+        }, [](int a, int b) { return a + b; }, 0, cutoff);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && source.size() == sorted.size() && source.isValid());
+
+    // Obserwator ze zwykłymi (nieatomowymi) licznikami dostaje rotacje z operacji równoległych szeregowo
+    typedef AVLTree<int, std::less<int>, PoolAllocator, RecordingObserver> RecordedTree;
+    RecordedTree a, b;
+    for (int i = 0; i < 40000; i += 2) a.insert(i);
+    for (int i = 1; i < 40000; i += 2) b.insert(i);
+    a.parallel_union(b, cutoff);
+    assert(a.isValid() && a.size() == 40000);
+    a.parallel_filter([](int v) { return v % 5 != 0; }, cutoff);
+    assert(a.isValid() && a.size() == 32000);
+    assert(a.get_observer().leftRotations + a.get_observer().rightRotations > 0);
+}
+
+void test32(bool debug) {
+    std::cout << "\033[33m====================  TEST 32 ====================\033[0m" << std::endl;
+    (void)debug;
+    // Przeniesione drzewo zabiera swoją pulę, a źródło dostaje nową, niewspółdzieloną
+    AVLTree<int> source;
+    for (int i = 0; i < 1000; ++i) source.insert(i);
+    PoolAllocator original = source.get_allocator();
+    AVLTree<int> moved(std::move(source));
+    assert(moved.get_allocator() == original && source.get_allocator() != original);
+    assert(source.empty() && moved.size() == 1000 && moved.isValid());
+    source.insert(5);
+    assert(source.size() == 1 && source.isValid());
+
+    // Przypisanie kopiujące daje silną gwarancję - nieudana kopia nie zmienia celu
+    AVLTree<FragileValue> from, to;
+    for (int i = 0; i < 100; ++i) from.insert(FragileValue(i));
+    for (int i = 500; i < 510; ++i) to.insert(FragileValue(i));
+    FragileValue::copiesLeft = 50;
+    bool thrown = false;
+    try {
+        to = from;
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    FragileValue::copiesLeft = -1;
+    assert(thrown && to.size() == 10 && to.isValid() && to.find_min().key == 500);
+    to = from;
+    assert(to.size() == 100 && to.isValid() && to.find_max().key == 99);
+
+    // Przypisanie kopiujące zachowuje alokator celu, także współdzieloną pulę
+    PoolAllocator shared(16);
+    AVLTree<int> left(shared), right(shared), other;
+    for (int i = 0; i < 100; ++i) other.insert(i);
+    left.insert(-1);
+    left = other;
+    right = other;
+    assert(left.get_allocator() == shared && right.get_allocator() == shared);
+    assert(left.size() == 100 && right.size() == 100 && left.isValid() && right.isValid());
+
+    // Przypisanie przenoszące zamienia alokatory, a pusty uchwyt źródła działa dalej
+    AVLTree<int> emptied(std::move(left));
+    assert(emptied.size() == 100 && left.empty());
+    other = std::move(emptied);
+    assert(other.size() == 100 && emptied.empty() && other.get_allocator() == shared);
+    for (int i = 0; i < 10; ++i) left.insert(i);
+    left.clear();
+    assert(left.empty() && left.isValid());
 }
 
 int main() {
@@ -258,6 +1587,31 @@ int main() {
     test5(debug);
     test6(debug);
     test7(debug);
+    test8(debug);
+    test9(debug);
+    test10(debug);
+    test11(debug);
+    test12(debug);
+    test13(debug);
+    test14(debug);
+    test15(debug);
+    test16(debug);
+    test17(debug);
+    test18(debug);
+    test19(debug);
+    test20(debug);
+    test21(debug);
+    test22(debug);
+    test23(debug);
+    test24(debug);
+    test25(debug);
+    test26(debug);
+    test27(debug);
+    test28(debug);
+    test29(debug);
+    test30(debug);
+    test31(debug);
+    test32(debug);
 
     std::cout << "\033[32mWszystkie testy zostały zaliczone!\033[0m" << std::endl;
     return 0;